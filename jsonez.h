@@ -30,6 +30,10 @@
 #define INCLUDE_JSONEZ_H
 
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -57,9 +61,9 @@ typedef _Bool bool;
 #endif
 
 
-#ifndef JSON_REPORT_ERROR
-#define JSON_REPORT_ERROR(msg, p) fprintf(stderr, "PARSE ERROR (%d): " msg " at %s\n", __LINE__, p)
-#endif
+// parse errors are only reported through jsonez_parse_opts, nothing is
+// printed. define JSON_REPORT_ERROR(msg, snippet) before including this to
+// hear about them as they happen, snippet is a bit of the input from there.
 
 
 typedef enum jsonez_type {
@@ -74,6 +78,7 @@ typedef enum jsonez_type {
 
 typedef struct jsonez {
 	jsonez_type type;
+	unsigned int flags; // JSONEZ_NODE_* ownership bits, managed by the library
 	char *key;
 	union {
 		char *s; // string 
@@ -82,9 +87,25 @@ typedef struct jsonez {
 	};
 	struct jsonez *next;
 	struct jsonez *child;
+	struct jsonez *prev; // previous sibling, the first child points at the last one
+	union {
+		struct jsonez_index *index; // key lookup table for wide objects
+		struct jsonez_items *items; // item table for long arrays
+		int64_t i64; // exact value of a JSONEZ_NODE_INT number
+		uint64_t u64; // exact value of a JSONEZ_NODE_UINT number
+	};
+	unsigned int key_len;
+	unsigned int key_hash;
 } jsonez;
 
 
+// numbers always have n, integral ones that fit also carry one of these
+// flags and their exact value. writing n directly leaves that stale, so go
+// through the create functions or clear the flags too.
+#define JSONEZ_NODE_INT 0x10 // i64 holds the value
+#define JSONEZ_NODE_UINT 0x20 // u64 holds the value, which is above INT64_MAX
+
+
 typedef struct jsonez_ctx {
 	bool quote_keys;
 	int indent_length;
@@ -93,12 +114,191 @@ typedef struct jsonez_ctx {
 } jsonez_ctx;
 
 
+// an arena hands out nodes, keys and strings from big blocks so a whole
+// document goes away with one jsonez_arena_reset() or jsonez_arena_destroy()
+typedef struct jsonez_arena jsonez_arena;
+
+
+// parse flags
+#define JSONEZ_PARSE_INDEX 0x1 // build key indexes for wide objects while parsing
+#define JSONEZ_PARSE_INSITU 0x2 // unescape in place, keys and strings point into the input, which has to outlive the tree
+#define JSONEZ_PARSE_KEEP_MAP 0x4 // jsonez_parse_file keeps the file mapped and strings borrow from it
+#define JSONEZ_PARSE_TWO_STAGE 0x8 // index every token with a vectorized pass, then build the tree from the index, ignored with JSONEZ_PARSE_INSITU or JSONEZ_PARSE_PARALLEL
+#define JSONEZ_PARSE_PARALLEL 0x10 // parse a big array of objects or arrays at the top level on several threads, ignored with an arena
+
+
+// interned keys. every document gets its own pool unless one is shared
+// through jsonez_parse_opts, which then has to outlive those documents.
+// a pool is not thread safe.
+typedef struct jsonez_keypool jsonez_keypool;
+
+
+typedef enum jsonez_error_code {
+	JSONEZ_OK,
+	JSONEZ_ERROR_SYNTAX, // something that can't be there
+	JSONEZ_ERROR_EOF, // the input ended too soon
+	JSONEZ_ERROR_KEY, // a broken key or a missing separator
+	JSONEZ_ERROR_STRING, // an unterminated string or an unknown escape
+	JSONEZ_ERROR_NUMBER,
+	JSONEZ_ERROR_LITERAL, // neither true nor false
+	JSONEZ_ERROR_COMMENT,
+	JSONEZ_ERROR_MEMORY,
+} jsonez_error_code;
+
+
+// the first thing that went wrong in a parse
+typedef struct jsonez_error {
+	jsonez_error_code code;
+	const char *message; // static text, null with JSONEZ_OK
+	size_t offset; // bytes from the start of the input
+} jsonez_error;
+
+
+typedef struct jsonez_parse_opts {
+	int flags;
+	jsonez_arena *arena;
+	jsonez_keypool *keys;
+	int threads; // for JSONEZ_PARSE_PARALLEL, 0 means one per core
+	jsonez_error *error; // filled in when the parse is done, JSONEZ_OK or not
+} jsonez_parse_opts;
+
+
+// these give a tree even for broken input, null only when there is no
+// memory for its root. running out later leaves JSONEZ_ERROR_MEMORY.
 JSONEZDEF jsonez *jsonez_parse(char *file);
+JSONEZDEF jsonez *jsonez_parse_arena(jsonez_arena *arena, char *file);
+JSONEZDEF jsonez *jsonez_parse_ex(char *file, jsonez_parse_opts *opts);
+// parses exactly len bytes, which need no terminator and are never written
+JSONEZDEF jsonez *jsonez_parse_n(const char *data, size_t len, jsonez_parse_opts *opts);
+// maps the file instead of reading it, null if it can't be opened
+JSONEZDEF jsonez *jsonez_parse_file(const char *path, jsonez_parse_opts *opts);
+// 1 based line and column of an error in the input it came from, which is
+// only scanned for them now
+JSONEZDEF void jsonez_error_position(const char *data, const jsonez_error *error, size_t *line, size_t *column);
+
+
+// push parsing for input that arrives in pieces. chunks can split anywhere,
+// even inside a string or number, and the tree is built as they come in.
+// feed returns false once the input is broken, later chunks are ignored.
+// finish parses what is left, frees the stream and returns the tree,
+// which holds whatever was parsed even after an error.
+typedef struct jsonez_stream jsonez_stream;
+
+JSONEZDEF jsonez_stream *jsonez_stream_new(jsonez_parse_opts *opts);
+JSONEZDEF bool jsonez_stream_feed(jsonez_stream *stream, const char *chunk, size_t len);
+JSONEZDEF jsonez *jsonez_stream_finish(jsonez_stream *stream);
+
+
+// newline delimited input, one document per line. a record ends at the
+// first newline outside strings and block comments, lines with only
+// whitespace and comments aren't records. chunks of the input are split and parsed on a pool of threads.
+typedef struct jsonez_record {
+	size_t index; // counts records from 0
+	size_t offset; // where it starts in the input
+	size_t len; // with the newline
+	jsonez *json; // belongs to the callback, and holds what got parsed even when broken
+	jsonez_error error; // JSONEZ_OK unless the record is broken, offset is in the whole input
+} jsonez_record;
+
+// returning false stops the read
+typedef bool (*jsonez_record_fn)(void *user, jsonez_record *record);
+
+typedef struct jsonez_ndjson_opts {
+	int threads; // 0 for one per core
+	bool unordered; // call back from the workers as soon as a record is parsed, otherwise in order from the calling thread
+	int flags; // parse flags for every record
+} jsonez_ndjson_opts;
+
+// false when a callback stopped it or memory ran out, broken records
+// don't stop anything. opts can be null.
+JSONEZDEF bool jsonez_parse_ndjson(const char *data, size_t len, jsonez_ndjson_opts *opts, jsonez_record_fn fn, void *user);
+JSONEZDEF bool jsonez_parse_ndjson_file(const char *path, jsonez_ndjson_opts *opts, jsonez_record_fn fn, void *user);
+
+
+// events for reading a document without building a tree. keys and strings
+// are slices of the input, or of scratch memory when they had escapes, and
+// are only valid during the call. number gets the text as well so exact
+// integers can be had. an item with no key, which the tree parser takes
+// too, gets a null key. any callback can be null, returning false stops
+// the parse. the root is reported as an object, braces or not.
+typedef struct jsonez_handler {
+	bool (*begin_object)(void *user);
+	bool (*end_object)(void *user);
+	bool (*begin_array)(void *user);
+	bool (*end_array)(void *user);
+	bool (*key)(void *user, const char *s, size_t len);
+	bool (*string)(void *user, const char *s, size_t len);
+	bool (*number)(void *user, double value, const char *text, size_t len);
+	bool (*boolean)(void *user, bool value);
+	void *user;
+} jsonez_handler;
+
+// false on a syntax error or when a callback stopped it, error says which
+// and can be null. a stop leaves it JSONEZ_OK.
+JSONEZDEF bool jsonez_parse_sax(const char *data, size_t len, jsonez_handler *handler, jsonez_error *error);
+
+// checks data against the same grammar as the parser without building or
+// decoding anything, so it accepts exactly what jsonez_parse_n does, down to
+// the error it reports. after the root only whitespace and comments may
+// follow. error can be null. it only allocates for nesting deeper than 32
+// levels, and only converts numbers of 1e308 or more, where the digits alone
+// can't tell whether they overflow.
+JSONEZDEF bool jsonez_validate(const char *data, size_t len, jsonez_error *error);
+
+
+// lazy reading. a cursor is a position in the text, nothing is parsed
+// until a value is asked for and everything on the way to it is skipped by
+// a scan that only tracks brackets, strings and comments. the data has to
+// outlive the doc, and lookups are linear so they suit sparse reads.
+typedef struct jsonez_doc jsonez_doc;
+
+typedef struct jsonez_cursor {
+	jsonez_doc *doc;
+	const char *key; // where the key starts, null for array items
+	const char *p; // where the value starts
+	bool root;
+} jsonez_cursor;
+
+JSONEZDEF jsonez_doc *jsonez_doc_open(const char *data, size_t len);
+JSONEZDEF void jsonez_doc_close(jsonez_doc *doc);
+JSONEZDEF jsonez_cursor jsonez_doc_root(jsonez_doc *doc);
+
+// JSON_UNKNOWN when the cursor isn't on a value
+JSONEZDEF jsonez_type jsonez_cursor_type(jsonez_cursor *cursor);
+JSONEZDEF bool jsonez_cursor_find_field(jsonez_cursor *object, const char *key, jsonez_cursor *field);
+// walking objects and arrays, false once there is nothing more
+JSONEZDEF bool jsonez_cursor_child(jsonez_cursor *parent, jsonez_cursor *child);
+JSONEZDEF bool jsonez_cursor_next(jsonez_cursor *cursor);
+
+// false when the value isn't of that type. keys and strings with escapes
+// are decoded into the doc and only last until the next one is.
+JSONEZDEF bool jsonez_cursor_key(jsonez_cursor *cursor, const char **key, size_t *len);
+JSONEZDEF bool jsonez_cursor_get_string(jsonez_cursor *cursor, const char **s, size_t *len);
+JSONEZDEF bool jsonez_cursor_get_double(jsonez_cursor *cursor, double *value);
+JSONEZDEF bool jsonez_cursor_get_int64(jsonez_cursor *cursor, int64_t *value);
+JSONEZDEF bool jsonez_cursor_get_uint64(jsonez_cursor *cursor, uint64_t *value);
+JSONEZDEF bool jsonez_cursor_get_bool(jsonez_cursor *cursor, bool *value);
+
+
 JSONEZDEF void jsonez_free(jsonez *json);
 JSONEZDEF jsonez *jsonez_find(jsonez *parent, const char *key);
+// item i of an array in constant time, null past the end. long arrays
+// get a table of their items on the first call, or while parsing into an
+// arena or with JSONEZ_PARSE_INDEX. appending keeps it up to date, other
+// edits drop it until the next call.
+JSONEZDEF jsonez *jsonez_at(jsonez *array, size_t i);
+// children of an object or array, 0 for anything else
+JSONEZDEF size_t jsonez_size(jsonez *json);
 
 
-// TODO - can create some stuff without names to put in arrays
+// typed number access, false when json is not a number or the value does
+// not fit. doubles that happen to be whole and in range still convert.
+JSONEZDEF bool jsonez_get_int64(jsonez *json, int64_t *value);
+JSONEZDEF bool jsonez_get_uint64(jsonez *json, uint64_t *value);
+JSONEZDEF bool jsonez_get_double(jsonez *json, double *value);
+
+
+// a null key makes a nameless value, which is what array items are
 JSONEZDEF jsonez *jsonez_create_root();
 JSONEZDEF jsonez *jsonez_create_object(jsonez *parent, char *key);
 JSONEZDEF jsonez *jsonez_create_array(jsonez *parent, char *key);
@@ -106,13 +306,106 @@ JSONEZDEF jsonez *jsonez_create_bool(jsonez *parent, char *key, bool value);
 JSONEZDEF jsonez *jsonez_create_numd(jsonez *parent, char *key, double value);
 JSONEZDEF jsonez *jsonez_create_numf(jsonez *parent, char *key, float value);
 JSONEZDEF jsonez *jsonez_create_numi(jsonez *parent, char *key, int value);
+JSONEZDEF jsonez *jsonez_create_int64(jsonez *parent, char *key, int64_t value);
+JSONEZDEF jsonez *jsonez_create_uint64(jsonez *parent, char *key, uint64_t value);
 JSONEZDEF jsonez *jsonez_create_string(jsonez *parent, char *key, char *value);
 
 
+// moving things around. detach hands the child back without freeing it,
+// with its own copies of any keys and strings it shared with the parsed
+// document, so it outlives that document. that walks the child, null when
+// the copies don't fit in memory. delete and insert_before are O(1),
+// insert_before appends when before is null.
+JSONEZDEF jsonez *jsonez_detach(jsonez *parent, jsonez *child);
+JSONEZDEF void jsonez_delete(jsonez *parent, jsonez *child);
+JSONEZDEF jsonez *jsonez_insert_before(jsonez *parent, jsonez *before, jsonez *item);
+
+
 JSONEZDEF char *jsonez_to_string(jsonez *root, jsonez_ctx *ctx);
+// same text written into buf without allocating, false when it doesn't fit.
+// needed gets the size it takes including the terminator either way.
+JSONEZDEF bool jsonez_to_buffer(jsonez *root, jsonez_ctx *ctx, char *buf, size_t cap, size_t *needed);
+
+
+// where jsonez_write sends its text, a chunk at a time. write returns
+// false to give up, which jsonez_write then passes on.
+typedef struct jsonez_sink {
+	bool (*write)(void *user, const char *data, size_t len);
+	void *user;
+} jsonez_sink;
+
+// streams the same text as jsonez_to_string through a fixed staging buffer,
+// so memory use doesn't grow with the output
+JSONEZDEF bool jsonez_write(jsonez *root, jsonez_ctx *ctx, jsonez_sink *sink);
+JSONEZDEF jsonez_sink jsonez_file_sink(FILE *file);
+JSONEZDEF jsonez_sink jsonez_fd_sink(int fd);
 JSONEZDEF void jsonez_free_string(char *string);
 
 
+// a flat document. nodes sit in one array in document order and refer to
+// each other by index, so walking or printing all of it is a forward scan.
+// keys and strings are packed together in text. the root is node 0, which
+// doubles as "none" since nothing else can point at it. offsets are 32 bits
+// so a tape is limited to 4GB of text.
+typedef struct jsonez_tape_node {
+	unsigned char type; // a jsonez_type
+	unsigned char flags; // JSONEZ_NODE_INT or JSONEZ_NODE_UINT on numbers
+	unsigned int key; // offset into text, 0 for array items and the root
+	unsigned int key_len;
+	unsigned int key_hash;
+	unsigned int next; // the following sibling
+	unsigned int count; // children of objects and arrays, length of strings
+	union {
+		double n;
+		bool b;
+	};
+	union {
+		int64_t i64;
+		uint64_t u64;
+		uint64_t s; // offset of a string into text
+	};
+} jsonez_tape_node;
+
+typedef struct jsonez_tape {
+	jsonez_tape_node *nodes;
+	size_t count;
+	char *text; // every key and string is terminated
+	size_t text_len;
+	size_t nodes_size;
+	size_t text_size;
+} jsonez_tape;
+
+// keeps what was parsed of a broken document like jsonez_parse does,
+// null only when memory runs out
+JSONEZDEF jsonez_tape *jsonez_tape_parse(const char *data, size_t len);
+JSONEZDEF void jsonez_tape_free(jsonez_tape *tape);
+// nodes are indexes, 0 when there is no such node
+JSONEZDEF size_t jsonez_tape_find(jsonez_tape *tape, size_t parent, const char *key);
+JSONEZDEF size_t jsonez_tape_child(jsonez_tape *tape, size_t node);
+JSONEZDEF size_t jsonez_tape_next(jsonez_tape *tape, size_t node);
+// null when the node has no key or isn't a string
+JSONEZDEF const char *jsonez_tape_key(jsonez_tape *tape, size_t node);
+JSONEZDEF const char *jsonez_tape_string(jsonez_tape *tape, size_t node);
+// the classic tree with the same contents, free it with jsonez_free. null
+// when memory runs out
+JSONEZDEF jsonez *jsonez_tape_to_tree(jsonez_tape *tape);
+// the same text jsonez_to_string and jsonez_write make from the tree
+JSONEZDEF char *jsonez_tape_to_string(jsonez_tape *tape, jsonez_ctx *ctx);
+JSONEZDEF bool jsonez_tape_write(jsonez_tape *tape, jsonez_ctx *ctx, jsonez_sink *sink);
+
+
+// size_hint is the first block size, 0 picks a default. reset keeps the
+// memory around and sizes the next block from what the last parse used.
+JSONEZDEF jsonez_arena *jsonez_arena_create(size_t size_hint);
+JSONEZDEF void jsonez_arena_reset(jsonez_arena *arena);
+JSONEZDEF void jsonez_arena_destroy(jsonez_arena *arena);
+JSONEZDEF size_t jsonez_arena_used(jsonez_arena *arena);
+
+
+JSONEZDEF jsonez_keypool *jsonez_keypool_create();
+JSONEZDEF void jsonez_keypool_destroy(jsonez_keypool *pool);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -141,830 +434,7483 @@ JSONEZDEF void jsonez_free_string(char *string);
 #ifdef JSONEZ_IMPLEMENTATION
 
 
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// JSONEZ_NO_THREADS reads ndjson and parses big arrays on the calling thread alone
+#ifndef JSONEZ_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+#endif
+
+
+// JSONEZ_NO_SIMD keeps everything scalar, JSONEZ_NO_AVX2 stops at SSE2
+#ifndef JSONEZ_NO_SIMD
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define JSONEZ_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(JSONEZ_NO_AVX2)
+#define JSONEZ_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define JSONEZ_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
 #define JSONEZ_BETWEEN(a,b,c) ((a) >= (b) && (a) <= (c))
 #define JSONEZ_RAW_KEY(c) (JSONEZ_BETWEEN((c),'0','9')||JSONEZ_BETWEEN((c),'a','z')||JSONEZ_BETWEEN((c),'A','Z')||((c)=='_'))
 #define JSONEZ_WHITESPACE(c) (JSONEZ_BETWEEN((c),0,32))
 #define JSONEZ_ESCAPE(c) ((c)=='"'||(c)=='\\'||(c)=='/'||(c)=='b'||(c)=='f'||(c)=='n'||(c)=='r'||(c)=='t')
 #define JSONEZ_VALID_STRING(c) (JSONEZ_BETWEEN((c),' ','~'))
 #define JSONEZ_NUMBER(c) (JSONEZ_BETWEEN((c),'0','9')||(c)=='e'||(c)=='E'||(c)=='+'||(c)=='-'||(c)=='.')
-#define JSONEZ_SKIP_WHITESPACE(p) while( (p) && *(p) && JSONEZ_WHITESPACE(*(p))) { (p)++; }
-#define JSONEZ_IS_SINGLE_COMMENT(p) (p && (*p) && (*p=='/') && (*(p+1)) && (*(p+1)=='/'))
-#define JSONEZ_IS_MULTI_COMMENT(p) (p && (*p) && (*p=='/') && (*(p+1)) && (*(p+1)=='*'))
 
+// the byte at p, or '\0' past the end of the input
+#define JSONEZ_AT(ps, p) ((p) < (ps)->end ? *(p) : '\0')
 
-#define JSONEZ_WRITE_STRING(stf, fmt, ...) do { \
-	int written = snprintf(stf->ptr, stf->remaining, fmt, ##__VA_ARGS__); \
-	stf->total += written; \
-	if (stf->ptr) stf->ptr += written; \
-	stf->remaining -= written; \
-	if (stf->remaining < 0) stf->remaining = 0; \
+#ifdef JSON_REPORT_ERROR
+#define JSONEZ_ERROR(ps, code, msg, p) do { \
+	char jsonez_snippet_buf[32]; \
+	jsonez_fail(ps, code, msg, p); \
+	JSON_REPORT_ERROR(msg, jsonez_snippet(ps, p, jsonez_snippet_buf, sizeof(jsonez_snippet_buf))); \
 } while(0)
+#else
+#define JSONEZ_ERROR(ps, code, msg, p) jsonez_fail(ps, code, msg, p)
+#endif
 
 
-typedef struct jsonez_output {
 
-	char *ptr;
-	int total;
-	int remaining;
 
-} jsonez_output;
+#ifndef JSONEZ_ARENA_BLOCK_SIZE
+#define JSONEZ_ARENA_BLOCK_SIZE (64*1024)
+#endif
 
+#define JSONEZ_ARENA_ALIGN(n) (((n) + 7) & ~(size_t)7)
 
-static char *jsonez_parse_object(jsonez *parent, char *p);
-static void jsonez_print_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx);
-static void jsonez_print_value(jsonez_output *out, int space, jsonez *value, jsonez_ctx *ctx);
+// objects with at least this many children get a hashed key index,
+// arrays get a table of their items
+#ifndef JSONEZ_INDEX_THRESHOLD
+#define JSONEZ_INDEX_THRESHOLD 16
+#endif
 
+// node flags
+#define JSONEZ_NODE_ARENA 0x1 // node, key and string live in an arena
+#define JSONEZ_NODE_KEY_BORROWED 0x2 // key belongs to someone else, like a key pool
+#define JSONEZ_NODE_DOC 0x4 // root node of a jsonez_document
+#define JSONEZ_NODE_STR_BORROWED 0x8 // string points into the parsed input
 
-static char *jsonez_skip_whitespace(char *p) {
-	JSONEZ_SKIP_WHITESPACE(p);
-	while (JSONEZ_IS_SINGLE_COMMENT(p) || JSONEZ_IS_MULTI_COMMENT(p)) {
-		if (JSONEZ_IS_SINGLE_COMMENT(p)) {
-			while(*p && (*p != '\n')) {
-				++p;
-			}
-			if (p == NULL || *p != '\n') {
-				JSON_REPORT_ERROR("malformed single line comment", p);
-			}
-		} else if (JSONEZ_IS_MULTI_COMMENT(p)) {
-			bool end = false;
-			while (*p) {
-				bool maybe = *p++ == '*';
-				if (maybe && (*p++ == '/')) {
-					end = true;
-					break;
-				}
-			}
-			if (!end) {
-				JSON_REPORT_ERROR("malformed /* */ multiline comment", p);
-			}
-		}
-		JSONEZ_SKIP_WHITESPACE(p);
-	}
-	return p;
-}
 
+// text is appended into buf while it fits. a growable buffer is heap
+// memory that doubles when it fills up, a fixed one just stops taking
+// bytes, either way len keeps counting what the whole text needs. with a
+// sink buf is staging instead and gets handed over every time it fills.
+typedef struct jsonez_output {
 
-static jsonez *jsonez_create(jsonez *parent, char *key) {
+	char *buf;
+	size_t len;
+	size_t cap;
+	bool grow;
+	bool failed; // out of memory, or the sink gave up
+	jsonez_sink *sink;
 
-	jsonez *json = (jsonez *)calloc(1, sizeof(jsonez));
-	json->type = JSON_UNKNOWN;
-	if (key) {
-		json->key = strdup(key);
-	} 
+} jsonez_output;
 
-	if(!parent->child) {
-		parent->child = json;
-	} else {
-		jsonez *child = parent->child;
-		while(child->next) {
-			child = child->next;
-		}
-		child->next = json;
-	}
 
-	parent->i++;
-	return json;
-}
+#ifndef JSONEZ_WRITE_CHUNK
+#define JSONEZ_WRITE_CHUNK 8192 // staging buffer size for jsonez_write
+#endif
 
 
-static char *jsonez_next_arr(char *p) {
+typedef struct jsonez_arena_block {
 
-	p = jsonez_skip_whitespace(p);
+	struct jsonez_arena_block *next;
+	size_t size;
+	size_t used;
 
-	if(*p==',') {
-		p++;
-	}
+} jsonez_arena_block;
 
-	p = jsonez_skip_whitespace(p);
 
-	if(*p==']') return p;
-	if(*p=='{'||*p=='['||*p=='"'||*p=='t'||*p=='f'||JSONEZ_NUMBER(*p)) return p;
+struct jsonez_arena {
 
-	JSON_REPORT_ERROR("Neverending Array",p);
-	return 0; // error of some king
+	jsonez_arena_block *head;
+	size_t size_hint;
 
-}
+};
 
 
-static char *jsonez_next_obj(char *p) {
+// open addressing with linear probing, kept at most half full
+typedef struct jsonez_index {
 
-	p = jsonez_skip_whitespace(p);
+	unsigned int mask;
+	unsigned int count;
+	unsigned int dups; // keys seen more than once, the first one wins
+	bool arena;
+	jsonez *slots[];
 
-	if(*p=='\0') return p;
-	if(*p=='}'||*p==']') return p;
+} jsonez_index;
 
-	if(*p==',') {
-		p++;
-	} else {
-		JSON_REPORT_ERROR("Next item missing",p);
-		return 0; //error of some king
-	}
 
-	p = jsonez_skip_whitespace(p);
+// an array's items in order, with room to append
+typedef struct jsonez_items {
 
-	if(*p=='\0') return p;
-	if(*p=='}'||*p==']') return p;
-	if(*p=='"'||*p=='t'||*p=='f'||JSONEZ_RAW_KEY(*p)) return p;
+	unsigned int count;
+	unsigned int size;
+	bool arena;
+	jsonez *at[];
 
-	JSON_REPORT_ERROR("Unexptected end of file",p);
-	return 0; // error of some king
+} jsonez_items;
 
-}
 
+typedef struct jsonez_keypool_entry {
 
-static char *jsonez_skip_key_separator(char *p) {
+	char *key;
+	unsigned int len;
+	unsigned int hash;
 
-	p = jsonez_skip_whitespace(p);
+} jsonez_keypool_entry;
 
-	if(*p==':' || *p=='=') {
-		p++;
-	} else {
-		JSON_REPORT_ERROR("Missing ':' key separator",p);
-		return 0; // error of some kind
-	}
 
-	p = jsonez_skip_whitespace(p);
+struct jsonez_keypool {
 
-	if(*p=='"'||*p=='t'||*p=='f'||JSONEZ_NUMBER(*p)||*p=='['||*p=='{') return p;
+	jsonez_arena *arena; // where the keys live
+	bool owns_arena; // otherwise the table comes out of the arena too
+	unsigned int mask;
+	unsigned int count;
+	jsonez_keypool_entry *slots;
 
-	JSON_REPORT_ERROR("Unknow Value type",p);
-	return 0; // error of some kind
+};
 
-}
 
+// the root node of a parse, with whatever the tree needs to stay alive
+typedef struct jsonez_document {
 
-static char *jsonez_parse_quote_string(char **key, char *p) {
+	jsonez root;
+	jsonez_keypool *keys; // null when the keys are in a shared pool
+	void *map; // the file strings borrow from, see JSONEZ_PARSE_KEEP_MAP
+	size_t map_size;
 
-	char *s = p;
-	int len = 0;
-	char c = 0;
+} jsonez_document;
 
-	while((c=*++p)) {
-		if(c == '\\') {
-			p++;
-			if(*p && JSONEZ_ESCAPE(*p)) {
-				len++;
-			} else {
-				JSON_REPORT_ERROR("Unknown escape sequence", p);
-				return 0;
-			}
-		} else if(c == '"') {
-			break;
-		} else if(JSONEZ_VALID_STRING(c)) {
-			len++;
-		}
-	}
-
-	if(c == '"') {
-		// copies over the escaped string
-		// actually return good string
-		// the len is not the actual length of the string
-		// but the escaped length
-		char *str = (char*)calloc(len+1, sizeof(char));
-		char *d = str;
-		for(int i = 0; i < len; ++i) {
-			if(*++s == '\\') {
-				switch(*++s) {
-					case '"': {
-						*d++ = '\"';
-					} break;
-					case '\\': {
-						*d++ = '\\';
-					} break;
-					case 'b': {
-						*d++ = '\b';
-					} break;
-					case 'f': {
-						*d++ = '\f';
-					} break;
-					case '/': {
-						*d++ = '/';
-					} break;
-					case 'n': {
-						*d++ = '\n';
-					} break;
-					case 'r': {
-						*d++ = '\r';
-					} break;
-					case 't': {
-						*d++ = '\t';
-					} break;
-					default: {
-						JSON_REPORT_ERROR("Unknown escape sequence", p);
-						return 0; // error of some kind
-					}
-				}
-			} else {
-				*d++ = *s;
-			}
-		}
-		str[len] = '\0';
-		*key = str;
-		return ++p;
-	}
 
-	JSON_REPORT_ERROR("Neverending Quoted String", p);
-	return 0;
-}
+typedef struct jsonez_key {
 
+	char *s;
+	unsigned int len;
+	unsigned int hash;
+	char *term; // in situ raw keys get terminated once the separator is read
 
-static char *jsonez_parse_raw_key(char **key, char *p) {
+} jsonez_key;
 
-	char *s = p;
-	int len = 0;
 
-	while(*p && JSONEZ_RAW_KEY(*p)) {
-		p++;
-		len++;
-	}
+// one bit per byte of a 64 byte block, see jsonez_stage1_block
+typedef struct jsonez_masks {
 
-	p = jsonez_skip_whitespace(p);
+	uint64_t quote;
+	uint64_t backslash;
+	uint64_t slash;
+	uint64_t star;
+	uint64_t newline;
+	uint64_t op; // {}[]:,=
+	uint64_t space;
+	uint64_t nul;
 
-	if(*p == ':' || *p == '=') {
-		// got a key
-		char *str = (char *)calloc(len+1, sizeof(char));		
-		strncpy(str, s, len);
-		str[len] = '\0';
-		*key = str;
-		return p;
-	} 
-	
-	JSON_REPORT_ERROR("Missing ':' key separator", p);
-	return 0;
-}
+} jsonez_masks;
 
 
-static char *jsonez_parse_bool_value(jsonez *parent, char *key, char *p) {
+// vectorized scanners, see jsonez_pick_kernels
+typedef struct jsonez_kernels {
 
-	jsonez *json = jsonez_create(parent, key);
+	const char *(*skip_space)(const char *p, const char *end);
+	const char *(*find_char)(const char *p, const char *end, char c);
+	const char *(*find_quote)(const char *p, const char *end); // '"', '\\' or terminator
+	const char *(*find_structural)(const char *p, const char *end); // brackets, '"', '/' or terminator
+	void (*classify)(const char *block, jsonez_masks *masks); // exactly 64 bytes
 
-	char c=*p++;
-	if(c=='t') {
-		if((c=*p++) && c=='r') {
-			if((c=*p++) && c=='u') {
-				if((c=*p++) && c=='e') {
-					json->type = JSON_BOOL;
-					json->i = 1;
-					return p;
-				}
-			}
-		}
-	} else if(c=='f') {
-		if((c=*p++) && c=='a') {
-			if((c=*p++) && c=='l') {
-				if((c=*p++) && c=='s') {
-					if((c=*p++) && c=='e') {
-						json->type = JSON_BOOL;
-						json->i = 0;
-						return p;
-					}
-				}
-			}
-		}
-	}
+} jsonez_kernels;
 
-	JSON_REPORT_ERROR("Unknow Value", p);
-	return 0;
 
-}
+// a container the parser is inside of, the explicit stack replaces recursion
+typedef enum jsonez_frame_kind {
+	JSONEZ_IN_ROOT, // braceless top level, ends at the end of the input
+	JSONEZ_IN_OBJECT,
+	JSONEZ_IN_ARRAY,
+	JSONEZ_IN_SLICE, // items of a bigger array, ends at the end of the input
+} jsonez_frame_kind;
 
 
-static char *jsonez_parse_number_value(jsonez *parent, char *key, char *p) {
+// what the stream parser wants next inside a frame
+typedef enum jsonez_expect {
+	JSONEZ_EXPECT_KEY,
+	JSONEZ_EXPECT_NEXT_KEY, // after a comma, where the key can't be left out
+	JSONEZ_EXPECT_SEP,
+	JSONEZ_EXPECT_VALUE,
+	JSONEZ_EXPECT_NEXT, // a comma or the end, arrays also take another value
+} jsonez_expect;
 
-	jsonez *json = jsonez_create(parent, key);
-	char* s = p;	
-	char* e = 0;
 
-	// find the first not a number
-	while(JSONEZ_NUMBER(*p)) {
-		e = p++;	
-	}
+typedef struct jsonez_frame {
 
-	// try parse int
-	errno = 0;
-	char *ee;
-	int i = strtol(s, &ee, 10);
-	if( errno == 0 && ((e+1) == ee) ) {
-		json->type = JSON_NUMBER;
-		json->n = i;
-		return p;
-	}
+	jsonez *node;
+	jsonez_frame_kind kind;
+	jsonez_expect expect;
 
-	// try to parse double
-	errno = 0;
-	ee = 0;
-	double n = strtod(s, &ee);
-	if(errno == 0 && ((e+1) == ee) ) {
-		json->type = JSON_NUMBER;
-		json->n = n;
-		return p;
-	}
+} jsonez_frame;
 
-	JSON_REPORT_ERROR("Invalid Number Format", p);
-	return 0;
 
-}
+#define JSONEZ_FRAMES_INLINE 32
 
 
-static char *jsonez_parse_string_value(jsonez *parent, char *key, char *p) {
+typedef struct jsonez_parser {
 
-	jsonez *json = jsonez_create(parent, key);
-	p = jsonez_parse_quote_string(&json->s, p);
-	json->type = JSON_STRING;
-	if(p) {
-		return p;
-	}
+	jsonez_arena *arena; // null means use the heap
+	int flags;
+	jsonez_document *doc;
+	jsonez_keypool *keys;
+	int threads; // see JSONEZ_PARSE_PARALLEL
 
-	return 0; // TODO - error
+	const char *end; // the input is never read at or past this
+	const jsonez_kernels *simd;
+	jsonez_handler *sax; // set when events go out instead of a tree
+	struct jsonez_stage1 *stage1; // set while a tree is built from a structural index
+	bool validate; // with sax, strings and numbers are only checked
+	bool stopped; // a callback returned false
+	jsonez number; // the last number sent as an event
 
-}
+	// strings with escapes are decoded here before they are copied out
+	char *scratch;
+	size_t scratch_size;
 
+	// open containers, on the heap once nesting gets past the inline ones
+	jsonez_frame *stack;
+	size_t depth;
+	size_t stack_size;
+	jsonez_frame frames[JSONEZ_FRAMES_INLINE];
 
-static char *jsonez_parse_array(jsonez *parent, char *p) {
+	// the first thing that went wrong, offsets count from begin. streams
+	// drop their chunks, base is what came before this one.
+	jsonez_error error;
+	jsonez_error *report; // gets error when the parse is done
+	const char *begin;
+	size_t base;
 
-	p = jsonez_skip_whitespace(p);
+} jsonez_parser;
 
-	while(*p) {
 
-		if(*p=='t'||*p=='f') {
-			p = jsonez_parse_bool_value(parent, parent->key, p);
-		} else if(*p=='"') {
-			p = jsonez_parse_string_value(parent, parent->key, p);
-		} else if(JSONEZ_NUMBER(*p)) {
-			p = jsonez_parse_number_value(parent, parent->key, p);
-		} else if(*p=='{') {
-			p++;
-			jsonez* child = jsonez_create(parent, parent->key);
-			p = jsonez_parse_object(child, p);
-		} else if(*p=='[') {
-			p++;
-			jsonez* child = jsonez_create(parent, parent->key);
-			p = jsonez_parse_array(child, p);
-		}
+static void jsonez_print_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx);
+static void jsonez_print_value(jsonez_output *out, int space, jsonez *value, jsonez_ctx *ctx);
+static const char *jsonez_parse_parallel(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p);
 
-		p = jsonez_next_arr(p);
-		if(*p==']') {
-			parent->type = JSON_ARRAY;
-			return p+1;
-		}
 
-		if(!p) return 0; // error?!?
-	}
+////////////////////////////////////////////////////////////////////////////////
+// SIMD scanning kernels
+//
+// the parser only asks a few questions of long runs of bytes: where does
+// this whitespace end, where is the next c, where does this string stop
+// being plain text, where is the next byte that matters when skipping a
+// whole value (all of them also stop at a terminator). classify sorts a
+// block of bytes into the classes the structural index is built from. each
+// instruction set answers them 16 or 32 bytes at a time, the best one the
+// cpu has gets picked the first time something is parsed.
+////////////////////////////////////////////////////////////////////////////////
 
-	JSON_REPORT_ERROR("Syntax Error", p);
-	return 0; // error of some kind
 
+static int jsonez_ctz(unsigned long long x) {
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return (int)i;
+#else
+	return __builtin_ctzll(x);
+#endif
 }
 
 
-static char *jsonez_parse_object(jsonez *parent, char *p) {
+static const char *jsonez_skip_space_scalar(const char *p, const char *end) {
 
-	p = jsonez_skip_whitespace(p);
+	while (p < end && *p && JSONEZ_WHITESPACE(*p)) {
+		p++;
+	}
+	return p;
 
-	while(*p) {
+}
 
-		if(*p=='}') {
-			parent->type = JSON_OBJ;
-			return p+1;
-		}
 
-		char *key = 0;
-		if(JSONEZ_RAW_KEY(*p)) {
-			p = jsonez_parse_raw_key(&key, p);
-		} else if(*p=='"') {
-			p = jsonez_parse_quote_string(&key, p);	
-		}
+static const char *jsonez_find_char_scalar(const char *p, const char *end, char c) {
 
-		//if(!p) {
-			//return 0; // some kind of error
-		//}
+	while (p < end && *p && *p != c) {
+		p++;
+	}
+	return p;
 
-		p = jsonez_skip_key_separator(p);
-		if (!p) {
-			free(key);
-			return 0; // TODO: error
-		}
-			
-		if(*p=='t'||*p=='f') {
-			p = jsonez_parse_bool_value(parent, key, p);
-		} else if(*p=='"') {
-			p = jsonez_parse_string_value(parent, key, p);
-		} else if(JSONEZ_NUMBER(*p)) {
-			p = jsonez_parse_number_value(parent, key, p);
-		} else if(*p=='{') {
-			p++;
-			jsonez* child = jsonez_create(parent, key);
-			p = jsonez_parse_object(child, p);
-		} else if(*p=='[') {
-			p++;
-			jsonez* child = jsonez_create(parent, key);
-			p = jsonez_parse_array(child, p);
-		}
+}
 
-		free(key);
-		p = jsonez_next_obj(p);
-		if(!p) return 0; // error?!?
-	}
 
-	JSON_REPORT_ERROR("Syntax Error", p);
-	return 0; // error of some kind
+static const char *jsonez_find_quote_scalar(const char *p, const char *end) {
+
+	while (p < end && *p && *p != '"' && *p != '\\') {
+		p++;
+	}
+	return p;
 
 }
 
 
-static char *json_parse_root(jsonez *parent, char *p) {
+// or-ing in 0x20 turns '[' and ']' into '{' and '}' and nothing else into them
+#define JSONEZ_STRUCTURAL(c) (((c) | 0x20) == '{' || ((c) | 0x20) == '}' || (c) == '"' || (c) == '/' || !(c))
 
-	p = jsonez_skip_whitespace(p);
+static const char *jsonez_find_structural_scalar(const char *p, const char *end) {
 
-	while(*p) {
+	while (p < end && !JSONEZ_STRUCTURAL(*p)) {
+		p++;
+	}
+	return p;
 
-		char *key = 0;
-		if(JSONEZ_RAW_KEY(*p)) {
-			p = jsonez_parse_raw_key(&key, p);
-		} else if(*p=='"') {
-			p = jsonez_parse_quote_string(&key, p);	
-		}
+}
 
-		if(!p) {
-			JSON_REPORT_ERROR("Error parsing key", p);
-			free(key);
-			return 0; 
-		}
 
-		p = jsonez_skip_key_separator(p);
-		if (!p) {
-			JSON_REPORT_ERROR("Error parsing separator", p);
-			free(key);
-			return 0; 
-		}
-		
-		if(*p=='t'||*p=='f') {
-			p = jsonez_parse_bool_value(parent, key, p);
-		} else if(*p=='"') {
-			p = jsonez_parse_string_value(parent, key, p);
-		} else if(JSONEZ_NUMBER(*p)) {
-			p = jsonez_parse_number_value(parent, key, p);
-		} else if(*p=='{') {
-			p++;
-			jsonez* child = jsonez_create(parent, key);
-			p = jsonez_parse_object(child, p);
-		} else if(*p=='[') {
-			p++;
-			jsonez* child = jsonez_create(parent, key);
-			p = jsonez_parse_array(child, p);
-		}
+#define JSONEZ_OP(c) (((c) | 0x20) == '{' || ((c) | 0x20) == '}' || (c) == ':' || (c) == ',' || (c) == '=')
 
-		free(key);
-		p = jsonez_next_obj(p);
-		if(*p=='\0') {
-			parent->type = JSON_OBJ;
-			return p;
-		}
+static void jsonez_classify_scalar(const char *block, jsonez_masks *masks) {
 
+	memset(masks, 0, sizeof(jsonez_masks));
+	for (int i = 0; i < 64; i++) {
+		char c = block[i];
+		uint64_t bit = 1ull << i;
+		masks->quote |= c == '"' ? bit : 0;
+		masks->backslash |= c == '\\' ? bit : 0;
+		masks->slash |= c == '/' ? bit : 0;
+		masks->star |= c == '*' ? bit : 0;
+		masks->newline |= c == '\n' ? bit : 0;
+		masks->op |= JSONEZ_OP(c) ? bit : 0;
+		masks->space |= c && JSONEZ_WHITESPACE(c) ? bit : 0;
+		masks->nul |= !c ? bit : 0;
 	}
 
-	JSON_REPORT_ERROR("Syntax Error", p);
-	return 0; // error of some kind
-
 }
 
 
-JSONEZDEF void jsonez_free(jsonez *json) {
+static const jsonez_kernels jsonez_kernels_scalar = {
+	jsonez_skip_space_scalar,
+	jsonez_find_char_scalar,
+	jsonez_find_quote_scalar,
+	jsonez_find_structural_scalar,
+	jsonez_classify_scalar,
+};
 
-	if (json) {
 
-		free(json->key);
-		if (json->type == JSON_STRING) {
-			free(json->s);
-		}
+#if JSONEZ_SSE2
 
-		if (json->child) {
-			jsonez_free(json->child);
-		}
+// whitespace is 1..32, as signed bytes so everything from 0x80 up is not
+static const char *jsonez_skip_space_sse2(const char *p, const char *end) {
 
-		if (json->next) {
-			jsonez_free(json->next);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i limit = _mm_set1_epi8(33);
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i space = _mm_and_si128(_mm_cmpgt_epi8(v, zero), _mm_cmplt_epi8(v, limit));
+		unsigned int mask = _mm_movemask_epi8(space) ^ 0xFFFF;
+		if (mask) {
+			return p + jsonez_ctz(mask);
 		}
-		free (json);
+		p += 16;
 	}
+	return jsonez_skip_space_scalar(p, end);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_parse(char *file) {
-
-	jsonez *json = (jsonez*)calloc(1, sizeof(jsonez));
+static const char *jsonez_find_char_sse2(const char *p, const char *end, char c) {
 
-	char *p = file;
-	if (p == 0 || strlen(p) == 0) {
-		json->type = JSON_OBJ;
-		return json;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i want = _mm_set1_epi8(c);
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, want), _mm_cmpeq_epi8(v, zero));
+		unsigned int mask = _mm_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 16;
 	}
-	
-	
-	p = jsonez_skip_whitespace(p);
+	return jsonez_find_char_scalar(p, end, c);
 
+}
 
-	if(*p=='{') {
-		p = jsonez_parse_object(json, p+1);
-	} else {
-		p = json_parse_root(json, p);	
-	}
 
-	
-	p = jsonez_skip_whitespace(p);
+static const char *jsonez_find_quote_sse2(const char *p, const char *end) {
 
-	if (!p) {
-		JSON_REPORT_ERROR("Unexpected end of file", p);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i slash = _mm_set1_epi8('\\');
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash));
+		hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, zero));
+		unsigned int mask = _mm_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 16;
 	}
-
-	json->type = JSON_OBJ;
-	return json;
+	return jsonez_find_quote_scalar(p, end);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_find(jsonez *parent, const char *key) {
-
-	if (parent == NULL)
-		return NULL;
-
-	jsonez *next = parent->child;
-	while(next) {
-		if(!strcmp(key, next->key)) {
-			return next;
+static const char *jsonez_find_structural_sse2(const char *p, const char *end) {
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lower = _mm_set1_epi8(0x20);
+	const __m128i open = _mm_set1_epi8('{');
+	const __m128i close = _mm_set1_epi8('}');
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i slash = _mm_set1_epi8('/');
+	while (end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i folded = _mm_or_si128(v, lower);
+		__m128i hit = _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close));
+		hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)));
+		hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, zero));
+		unsigned int mask = _mm_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
 		}
-		next = next->next;
+		p += 16;
 	}
-	return NULL;
+	return jsonez_find_structural_scalar(p, end);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_create_root() {
-
-	jsonez *obj = (jsonez *)calloc(1, sizeof(jsonez));
-	obj->type = JSON_OBJ;
-	return obj;
+static void jsonez_classify_sse2(const char *block, jsonez_masks *masks) {
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i limit = _mm_set1_epi8(33);
+	const __m128i lower = _mm_set1_epi8(0x20);
+	memset(masks, 0, sizeof(jsonez_masks));
+	for (int i = 0; i < 64; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(block + i));
+		__m128i folded = _mm_or_si128(v, lower);
+		__m128i op = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+		op = _mm_or_si128(op, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+		op = _mm_or_si128(op, _mm_cmpeq_epi8(v, _mm_set1_epi8('=')));
+		__m128i space = _mm_and_si128(_mm_cmpgt_epi8(v, zero), _mm_cmplt_epi8(v, limit));
+		masks->quote |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << i;
+		masks->backslash |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << i;
+		masks->slash |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('/'))) << i;
+		masks->star |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('*'))) << i;
+		masks->newline |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))) << i;
+		masks->op |= (uint64_t)_mm_movemask_epi8(op) << i;
+		masks->space |= (uint64_t)_mm_movemask_epi8(space) << i;
+		masks->nul |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) << i;
+	}
 
 }
 
 
-JSONEZDEF jsonez *jsonez_create_object(jsonez *parent, char *key) {
+static const jsonez_kernels jsonez_kernels_sse2 = {
+	jsonez_skip_space_sse2,
+	jsonez_find_char_sse2,
+	jsonez_find_quote_sse2,
+	jsonez_find_structural_sse2,
+	jsonez_classify_sse2,
+};
 
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_OBJ;
-	return obj;
+#endif // JSONEZ_SSE2
 
-}
 
+#if JSONEZ_AVX2
 
-JSONEZDEF jsonez *jsonez_create_array(jsonez *parent, char *key) {
+__attribute__((target("avx2")))
+static const char *jsonez_skip_space_avx2(const char *p, const char *end) {
 
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_ARRAY;
-	return obj;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i limit = _mm256_set1_epi8(33);
+	while (end - p >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		__m256i space = _mm256_and_si256(_mm256_cmpgt_epi8(v, zero), _mm256_cmpgt_epi8(limit, v));
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(space);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 32;
+	}
+	return jsonez_skip_space_sse2(p, end);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_create_bool(jsonez *parent, char *key, bool value) {
+__attribute__((target("avx2")))
+static const char *jsonez_find_char_avx2(const char *p, const char *end, char c) {
 
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_BOOL;
-	obj->i = value;
-	return obj;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i want = _mm256_set1_epi8(c);
+	while (end - p >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		__m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, want), _mm256_cmpeq_epi8(v, zero));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 32;
+	}
+	return jsonez_find_char_sse2(p, end, c);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_create_numd(jsonez *parent, char *key, double value) {
+__attribute__((target("avx2")))
+static const char *jsonez_find_quote_avx2(const char *p, const char *end) {
 
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_NUMBER;
-	obj->n = value;
-	return obj;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i slash = _mm256_set1_epi8('\\');
+	while (end - p >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		__m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash));
+		hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, zero));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 32;
+	}
+	return jsonez_find_quote_sse2(p, end);
 
 }
 
-JSONEZDEF jsonez *jsonez_create_numf(jsonez *parent, char *key, float value) {
 
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_NUMBER;
-	obj->n = value;
-	return obj;
+__attribute__((target("avx2")))
+static const char *jsonez_find_structural_avx2(const char *p, const char *end) {
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lower = _mm256_set1_epi8(0x20);
+	const __m256i open = _mm256_set1_epi8('{');
+	const __m256i close = _mm256_set1_epi8('}');
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i slash = _mm256_set1_epi8('/');
+	while (end - p >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)p);
+		__m256i folded = _mm256_or_si256(v, lower);
+		__m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close));
+		hit = _mm256_or_si256(hit, _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)));
+		hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, zero));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (mask) {
+			return p + jsonez_ctz(mask);
+		}
+		p += 32;
+	}
+	return jsonez_find_structural_sse2(p, end);
 
 }
 
 
-JSONEZDEF jsonez *jsonez_create_numi(jsonez *parent, char *key, int value) {
-
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_NUMBER;
-	obj->n = value;
-	return obj;
+__attribute__((target("avx2")))
+static void jsonez_classify_avx2(const char *block, jsonez_masks *masks) {
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i limit = _mm256_set1_epi8(33);
+	const __m256i lower = _mm256_set1_epi8(0x20);
+	memset(masks, 0, sizeof(jsonez_masks));
+	for (int i = 0; i < 64; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(block + i));
+		__m256i folded = _mm256_or_si256(v, lower);
+		__m256i op = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+		op = _mm256_or_si256(op, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+		op = _mm256_or_si256(op, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('=')));
+		__m256i space = _mm256_and_si256(_mm256_cmpgt_epi8(v, zero), _mm256_cmpgt_epi8(limit, v));
+		masks->quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << i;
+		masks->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << i;
+		masks->slash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'))) << i;
+		masks->star |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('*'))) << i;
+		masks->newline |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))) << i;
+		masks->op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << i;
+		masks->space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(space) << i;
+		masks->nul |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)) << i;
+	}
+
+}
+
+
+static const jsonez_kernels jsonez_kernels_avx2 = {
+	jsonez_skip_space_avx2,
+	jsonez_find_char_avx2,
+	jsonez_find_quote_avx2,
+	jsonez_find_structural_avx2,
+	jsonez_classify_avx2,
+};
+
+#endif // JSONEZ_AVX2
+
+
+#if JSONEZ_NEON
+
+// neon has no movemask, narrowing gives 4 bits per byte instead
+static unsigned long long jsonez_neon_mask(uint8x16_t hit) {
+
+	uint8x8_t narrow = vshrn_n_u16(vreinterpretq_u16_u8(hit), 4);
+	return vget_lane_u64(vreinterpret_u64_u8(narrow), 0);
+
+}
+
+
+static const char *jsonez_skip_space_neon(const char *p, const char *end) {
+
+	const int8x16_t zero = vdupq_n_s8(0);
+	const int8x16_t limit = vdupq_n_s8(33);
+	while (end - p >= 16) {
+		int8x16_t v = vld1q_s8((const int8_t *)p);
+		uint8x16_t space = vandq_u8(vcgtq_s8(v, zero), vcltq_s8(v, limit));
+		unsigned long long mask = ~jsonez_neon_mask(space);
+		if (mask) {
+			return p + (jsonez_ctz(mask) >> 2);
+		}
+		p += 16;
+	}
+	return jsonez_skip_space_scalar(p, end);
+
+}
+
+
+static const char *jsonez_find_char_neon(const char *p, const char *end, char c) {
+
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t want = vdupq_n_u8((uint8_t)c);
+	while (end - p >= 16) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)p);
+		uint8x16_t hit = vorrq_u8(vceqq_u8(v, want), vceqq_u8(v, zero));
+		unsigned long long mask = jsonez_neon_mask(hit);
+		if (mask) {
+			return p + (jsonez_ctz(mask) >> 2);
+		}
+		p += 16;
+	}
+	return jsonez_find_char_scalar(p, end, c);
+
+}
+
+
+static const char *jsonez_find_quote_neon(const char *p, const char *end) {
+
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t slash = vdupq_n_u8('\\');
+	while (end - p >= 16) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)p);
+		uint8x16_t hit = vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, slash));
+		hit = vorrq_u8(hit, vceqq_u8(v, zero));
+		unsigned long long mask = jsonez_neon_mask(hit);
+		if (mask) {
+			return p + (jsonez_ctz(mask) >> 2);
+		}
+		p += 16;
+	}
+	return jsonez_find_quote_scalar(p, end);
+
+}
+
+
+static const char *jsonez_find_structural_neon(const char *p, const char *end) {
+
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t lower = vdupq_n_u8(0x20);
+	const uint8x16_t open = vdupq_n_u8('{');
+	const uint8x16_t close = vdupq_n_u8('}');
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t slash = vdupq_n_u8('/');
+	while (end - p >= 16) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)p);
+		uint8x16_t folded = vorrq_u8(v, lower);
+		uint8x16_t hit = vorrq_u8(vceqq_u8(folded, open), vceqq_u8(folded, close));
+		hit = vorrq_u8(hit, vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, slash)));
+		hit = vorrq_u8(hit, vceqq_u8(v, zero));
+		unsigned long long mask = jsonez_neon_mask(hit);
+		if (mask) {
+			return p + (jsonez_ctz(mask) >> 2);
+		}
+		p += 16;
+	}
+	return jsonez_find_structural_scalar(p, end);
+
+}
+
+
+// a real movemask, one bit per byte, for the 64 bit masks
+static uint64_t jsonez_neon_bits(uint8x16_t hit) {
+
+	static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t m = vandq_u8(hit, vld1q_u8(weights));
+	m = vpaddq_u8(m, m);
+	m = vpaddq_u8(m, m);
+	m = vpaddq_u8(m, m);
+	return vgetq_lane_u16(vreinterpretq_u16_u8(m), 0);
+
+}
+
+
+static void jsonez_classify_neon(const char *block, jsonez_masks *masks) {
+
+	const int8x16_t zero = vdupq_n_s8(0);
+	const int8x16_t limit = vdupq_n_s8(33);
+	const uint8x16_t lower = vdupq_n_u8(0x20);
+	memset(masks, 0, sizeof(jsonez_masks));
+	for (int i = 0; i < 64; i += 16) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)block + i);
+		uint8x16_t folded = vorrq_u8(v, lower);
+		uint8x16_t op = vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}')));
+		op = vorrq_u8(op, vorrq_u8(vceqq_u8(v, vdupq_n_u8(':')), vceqq_u8(v, vdupq_n_u8(','))));
+		op = vorrq_u8(op, vceqq_u8(v, vdupq_n_u8('=')));
+		int8x16_t sv = vreinterpretq_s8_u8(v);
+		uint8x16_t space = vandq_u8(vcgtq_s8(sv, zero), vcltq_s8(sv, limit));
+		masks->quote |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8('"'))) << i;
+		masks->backslash |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8('\\'))) << i;
+		masks->slash |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8('/'))) << i;
+		masks->star |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8('*'))) << i;
+		masks->newline |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8('\n'))) << i;
+		masks->op |= jsonez_neon_bits(op) << i;
+		masks->space |= jsonez_neon_bits(space) << i;
+		masks->nul |= jsonez_neon_bits(vceqq_u8(v, vdupq_n_u8(0))) << i;
+	}
+
+}
+
+
+static const jsonez_kernels jsonez_kernels_neon = {
+	jsonez_skip_space_neon,
+	jsonez_find_char_neon,
+	jsonez_find_quote_neon,
+	jsonez_find_structural_neon,
+	jsonez_classify_neon,
+};
+
+#endif // JSONEZ_NEON
+
+
+static const jsonez_kernels *jsonez_pick_kernels() {
+
+	// every thread comes up with the same answer, so racing here is fine
+	static const jsonez_kernels *picked = NULL;
+	if (picked) {
+		return picked;
+	}
+
+	const jsonez_kernels *kernels = &jsonez_kernels_scalar;
+#if JSONEZ_SSE2
+	kernels = &jsonez_kernels_sse2;
+#endif
+#if JSONEZ_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		kernels = &jsonez_kernels_avx2;
+	}
+#endif
+#if JSONEZ_NEON
+	kernels = &jsonez_kernels_neon;
+#endif
+
+	picked = kernels;
+	return kernels;
+
+}
+
+
+#ifdef JSON_REPORT_ERROR
+// copies a bit of the input after p for error messages, since the input
+// doesn't have to be terminated
+static const char *jsonez_snippet(jsonez_parser *ps, const char *p, char *buf, size_t size) {
+
+	if (!p) {
+		return "(null)";
+	}
+	size_t len = 0;
+	while (len + 1 < size && p + len < ps->end && p[len]) {
+		len++;
+	}
+	memcpy(buf, p, len);
+	buf[len] = '\0';
+	return buf;
+
+}
+#endif
+
+
+// keeps the first error, anything after it tends to follow from it
+static void jsonez_fail(jsonez_parser *ps, jsonez_error_code code, const char *msg, const char *p) {
+
+	if (ps->error.code) {
+		return;
+	}
+	if (!p || p > ps->end) {
+		p = ps->end;
+	}
+	if (code == JSONEZ_ERROR_SYNTAX && (p == ps->end || !*p)) {
+		code = JSONEZ_ERROR_EOF;
+	}
+	ps->error.code = code;
+	ps->error.message = msg;
+	ps->error.offset = ps->base + (ps->begin && p ? (size_t)(p - ps->begin) : 0);
+
+}
+
+
+static const char *jsonez_skip_whitespace(jsonez_parser *ps, const char *p) {
+
+	if (!p) {
+		return p;
+	}
+
+	const char *end = ps->end;
+	for (;;) {
+		// most tokens are followed by one space or none, skip the call then
+		if (p < end && *p && JSONEZ_WHITESPACE(*p)) {
+			p = ps->simd->skip_space(p + 1, end);
+		}
+		if (end - p < 2 || p[0] != '/') {
+			return p;
+		}
+
+		if (p[1] == '/') {
+			p = ps->simd->find_char(p + 2, end, '\n');
+			if (JSONEZ_AT(ps, p) != '\n') {
+				JSONEZ_ERROR(ps, JSONEZ_ERROR_COMMENT, "malformed single line comment", p);
+				return p;
+			}
+		} else if (p[1] == '*') {
+			p += 2;
+			for (;;) {
+				p = ps->simd->find_char(p, end, '*');
+				if (JSONEZ_AT(ps, p) != '*') {
+					JSONEZ_ERROR(ps, JSONEZ_ERROR_COMMENT, "malformed /* */ multiline comment", p);
+					return p;
+				}
+				if (JSONEZ_AT(ps, p + 1) == '/') {
+					p += 2;
+					break;
+				}
+				p++;
+			}
+		} else {
+			return p;
+		}
+	}
+
+}
+
+
+static jsonez_arena_block *jsonez_arena_new_block(size_t size) {
+
+	jsonez_arena_block *block = (jsonez_arena_block *)malloc(sizeof(jsonez_arena_block) + size);
+	if (!block) {
+		return NULL;
+	}
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	return block;
+
+}
+
+
+static void *jsonez_arena_alloc(jsonez_arena *arena, size_t size) {
+
+	size = JSONEZ_ARENA_ALIGN(size);
+
+	jsonez_arena_block *block = arena->head;
+	if (!block || block->size - block->used < size) {
+		// grow geometrically so big documents only need a handful of blocks
+		size_t block_size = block ? block->size * 2 : arena->size_hint;
+		if (block_size < size) {
+			block_size = size;
+		}
+		block = jsonez_arena_new_block(block_size);
+		if (!block) {
+			return NULL;
+		}
+		block->next = arena->head;
+		arena->head = block;
+	}
+
+	void *mem = (char *)(block + 1) + block->used;
+	block->used += size;
+	return mem;
+
+}
+
+
+// zeroed memory from the arena, or the heap when there is no arena
+static void *jsonez_alloc(jsonez_arena *arena, size_t size) {
+
+	if (arena) {
+		void *mem = jsonez_arena_alloc(arena, size);
+		if (mem) {
+			memset(mem, 0, size);
+		}
+		return mem;
+	}
+	return calloc(1, size);
+
+}
+
+
+static char *jsonez_strdup(jsonez_arena *arena, const char *s) {
+
+	// not strdup, which strict C builds don't declare
+	size_t len = strlen(s);
+	char *str = arena ? (char *)jsonez_arena_alloc(arena, len + 1) : (char *)malloc(len + 1);
+	if (str) {
+		memcpy(str, s, len + 1);
+	}
+	return str;
+
+}
+
+
+// FNV-1a, good enough for keys and cheap to compute while parsing
+static unsigned int jsonez_hash(const char *key, size_t len) {
+
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < len; ++i) {
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619u;
+	}
+	return hash;
+
+}
+
+
+static bool jsonez_key_equals(jsonez *json, const char *key, size_t len, unsigned int hash) {
+
+	return json->key && json->key_hash == hash && json->key_len == len && !memcmp(json->key, key, len);
+
+}
+
+
+static void jsonez_set_key(jsonez *json, char *key) {
+
+	json->key = key;
+	json->key_len = (unsigned int)strlen(key);
+	json->key_hash = jsonez_hash(key, json->key_len);
+
+}
+
+
+static void jsonez_index_drop(jsonez *parent) {
+
+	if (parent->type == JSON_NUMBER) {
+		return; // the index is shared with the integer value
+	}
+	if (parent->type == JSON_ARRAY) {
+		if (parent->items && !parent->items->arena) {
+			free(parent->items);
+		}
+	} else if (parent->index && !parent->index->arena) {
+		free(parent->index);
+	}
+	parent->index = NULL;
+
+}
+
+
+static void jsonez_index_insert(jsonez_index *index, jsonez *json) {
+
+	unsigned int slot = json->key_hash & index->mask;
+	while (index->slots[slot]) {
+		if (jsonez_key_equals(index->slots[slot], json->key, json->key_len, json->key_hash)) {
+			index->dups++;
+			return;
+		}
+		slot = (slot + 1) & index->mask;
+	}
+	index->slots[slot] = json;
+	index->count++;
+
+}
+
+
+static jsonez *jsonez_index_lookup(jsonez_index *index, const char *key, size_t len, unsigned int hash) {
+
+	unsigned int slot = hash & index->mask;
+	while (index->slots[slot]) {
+		if (jsonez_key_equals(index->slots[slot], key, len, hash)) {
+			return index->slots[slot];
+		}
+		slot = (slot + 1) & index->mask;
+	}
+	return NULL;
+
+}
+
+
+static void jsonez_index_build(jsonez_arena *arena, jsonez *parent) {
+
+	unsigned int size = 32;
+	while (size < (unsigned int)parent->i * 2) {
+		size *= 2;
+	}
+
+	size_t bytes = sizeof(jsonez_index) + size * sizeof(jsonez *);
+	jsonez_index *index = (jsonez_index *)jsonez_alloc(arena, bytes);
+	if (!index) {
+		// lookups go back to scanning, which needs no memory
+		jsonez_index_drop(parent);
+		return;
+	}
+	index->mask = size - 1;
+	index->arena = arena != NULL;
+
+	for (jsonez *child = parent->child; child; child = child->next) {
+		if (child->key) {
+			jsonez_index_insert(index, child);
+		}
+	}
+
+	jsonez_index_drop(parent);
+	parent->index = index;
+
+}
+
+
+static void jsonez_index_add(jsonez_arena *arena, jsonez *parent, jsonez *json) {
+
+	jsonez_index *index = parent->index;
+	if (!json->key) {
+		return;
+	}
+	if ((index->count + 1) * 2 > index->mask + 1) {
+		// an arena index can't grow on the heap without leaking past a
+		// reset, so go back to scanning until somebody rebuilds it
+		if (index->arena && !arena) {
+			jsonez_index_drop(parent);
+		} else {
+			jsonez_index_build(arena, parent);
+		}
+		return;
+	}
+	jsonez_index_insert(index, json);
+
+}
+
+
+static void jsonez_index_remove(jsonez *parent, jsonez *json) {
+
+	jsonez_index *index = parent->index;
+	if (!json->key) {
+		return;
+	}
+	if (index->dups) {
+		// a duplicate further down might be the one to find now
+		jsonez_index_drop(parent);
+		return;
+	}
+
+	unsigned int slot = json->key_hash & index->mask;
+	while (index->slots[slot] != json) {
+		if (!index->slots[slot]) {
+			return;
+		}
+		slot = (slot + 1) & index->mask;
+	}
+
+	// backward shift delete so probe chains stay unbroken
+	unsigned int hole = slot;
+	index->slots[hole] = NULL;
+	index->count--;
+	for (;;) {
+		slot = (slot + 1) & index->mask;
+		jsonez *moved = index->slots[slot];
+		if (!moved) {
+			break;
+		}
+		unsigned int home = moved->key_hash & index->mask;
+		bool stays = hole <= slot ? (hole < home && home <= slot) : (hole < home || home <= slot);
+		if (!stays) {
+			index->slots[hole] = moved;
+			index->slots[slot] = NULL;
+			hole = slot;
+		}
+	}
+
+}
+
+
+static void jsonez_items_build(jsonez_arena *arena, jsonez *parent) {
+
+	unsigned int size = 16;
+	while (size < (unsigned int)parent->i) {
+		size *= 2;
+	}
+
+	size_t bytes = sizeof(jsonez_items) + size * sizeof(jsonez *);
+	jsonez_items *items = (jsonez_items *)jsonez_alloc(arena, bytes);
+	if (!items) {
+		jsonez_index_drop(parent);
+		return;
+	}
+	items->size = size;
+	items->arena = arena != NULL;
+
+	for (jsonez *child = parent->child; child; child = child->next) {
+		items->at[items->count++] = child;
+	}
+
+	jsonez_index_drop(parent);
+	parent->items = items;
+
+}
+
+
+// appending keeps the table, anything else in the middle drops it and the
+// next jsonez_at builds it again
+static void jsonez_items_add(jsonez_arena *arena, jsonez *parent, jsonez *before, jsonez *json) {
+
+	jsonez_items *items = parent->items;
+	if (before || (items->arena && !arena && items->count == items->size)) {
+		jsonez_index_drop(parent);
+	} else if (items->count == items->size) {
+		jsonez_items_build(arena, parent);
+	} else {
+		items->at[items->count++] = json;
+	}
+
+}
+
+
+static void jsonez_items_remove(jsonez *parent, jsonez *json) {
+
+	jsonez_items *items = parent->items;
+	if (items->count && items->at[items->count - 1] == json) {
+		items->count--;
+	} else {
+		jsonez_index_drop(parent);
+	}
+
+}
+
+
+// puts json in front of before, or at the end when before is null.
+// the first child's prev is the last child so both ends are O(1).
+static void jsonez_link(jsonez_arena *arena, jsonez *parent, jsonez *before, jsonez *json) {
+
+	if (!parent->child) {
+		parent->child = json;
+		json->prev = json;
+	} else if (!before) {
+		jsonez *tail = parent->child->prev;
+		tail->next = json;
+		json->prev = tail;
+		parent->child->prev = json;
+	} else {
+		json->next = before;
+		json->prev = before->prev;
+		if (before == parent->child) {
+			parent->child = json;
+		} else {
+			before->prev->next = json;
+		}
+		before->prev = json;
+	}
+
+	parent->i++;
+
+	if (parent->index && parent->type == JSON_ARRAY) {
+		jsonez_items_add(arena, parent, before, json);
+	} else if (parent->index) {
+		if (before && json->key && jsonez_index_lookup(parent->index, json->key, json->key_len, json->key_hash)) {
+			// it may now shadow a key further down, start over
+			jsonez_index_drop(parent);
+		} else {
+			jsonez_index_add(arena, parent, json);
+		}
+	}
+
+}
+
+
+static void jsonez_unlink(jsonez *parent, jsonez *json) {
+
+	if (parent->index && parent->type == JSON_ARRAY) {
+		jsonez_items_remove(parent, json);
+	} else if (parent->index) {
+		jsonez_index_remove(parent, json);
+	}
+
+	jsonez *first = parent->child;
+	if (json == first) {
+		parent->child = json->next;
+		if (json->next) {
+			json->next->prev = json->prev;
+		}
+	} else {
+		json->prev->next = json->next;
+		if (json->next) {
+			json->next->prev = json->prev;
+		} else {
+			first->prev = json->prev;
+		}
+	}
+
+	json->next = NULL;
+	json->prev = NULL;
+	parent->i--;
+
+}
+
+
+static jsonez *jsonez_new(jsonez_arena *arena) {
+
+	jsonez *json = (jsonez *)jsonez_alloc(arena, sizeof(jsonez));
+	if (!json) {
+		return NULL;
+	}
+	json->type = JSON_UNKNOWN;
+	if (arena) {
+		json->flags |= JSONEZ_NODE_ARENA;
+	}
+	return json;
+
+}
+
+
+static jsonez *jsonez_create(jsonez_arena *arena, jsonez *parent, char *key) {
+
+	jsonez *json = jsonez_new(arena);
+	if (!json) {
+		return NULL;
+	}
+	if (key) {
+		char *copy = jsonez_strdup(arena, key);
+		if (!copy) {
+			if (!arena) {
+				free(json);
+			}
+			return NULL;
+		}
+		jsonez_set_key(json, copy);
+	} 
+
+	if (parent) {
+		jsonez_link(arena, parent, NULL, json);
+	}
+	return json;
+}
+
+
+// size_hint is how many bytes of keys there could be, which keeps small
+// documents from taking a whole block each. null when memory runs out.
+static jsonez_keypool *jsonez_keypool_new(jsonez_arena *arena, size_t size_hint) {
+
+	jsonez_keypool *pool = (jsonez_keypool *)jsonez_alloc(arena, sizeof(jsonez_keypool));
+	if (!pool) {
+		return NULL;
+	}
+	pool->owns_arena = arena == NULL;
+	pool->arena = arena ? arena : jsonez_arena_create(size_hint < 4096 ? size_hint : 4096);
+	pool->mask = 63;
+	pool->slots = (jsonez_keypool_entry *)jsonez_alloc(arena, (pool->mask + 1) * sizeof(jsonez_keypool_entry));
+	if (!pool->arena || !pool->slots) {
+		// an arena's pieces go when the arena does
+		if (!arena) {
+			jsonez_arena_destroy(pool->arena);
+			free(pool->slots);
+			free(pool);
+		}
+		return NULL;
+	}
+	return pool;
+
+}
+
+
+static bool jsonez_keypool_grow(jsonez_keypool *pool) {
+
+	unsigned int size = (pool->mask + 1) * 2;
+	jsonez_arena *table_arena = pool->owns_arena ? NULL : pool->arena;
+	jsonez_keypool_entry *slots = (jsonez_keypool_entry *)jsonez_alloc(table_arena, size * sizeof(jsonez_keypool_entry));
+	if (!slots) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i <= pool->mask; ++i) {
+		jsonez_keypool_entry *entry = &pool->slots[i];
+		if (entry->key) {
+			unsigned int slot = entry->hash & (size - 1);
+			while (slots[slot].key) {
+				slot = (slot + 1) & (size - 1);
+			}
+			slots[slot] = *entry;
+		}
+	}
+
+	if (pool->owns_arena) {
+		free(pool->slots);
+	}
+	pool->slots = slots;
+	pool->mask = size - 1;
+	return true;
+
+}
+
+
+static char *jsonez_keypool_intern(jsonez_keypool *pool, const char *key, unsigned int len, unsigned int hash) {
+
+	unsigned int slot = hash & pool->mask;
+	while (pool->slots[slot].key) {
+		jsonez_keypool_entry *entry = &pool->slots[slot];
+		if (entry->hash == hash && entry->len == len && !memcmp(entry->key, key, len)) {
+			return entry->key;
+		}
+		slot = (slot + 1) & pool->mask;
+	}
+
+	// grow first, a table that couldn't grow must still have a free slot
+	if ((pool->count + 1) * 2 > pool->mask + 1) {
+		if (!jsonez_keypool_grow(pool)) {
+			return NULL;
+		}
+		slot = hash & pool->mask;
+		while (pool->slots[slot].key) {
+			slot = (slot + 1) & pool->mask;
+		}
+	}
+
+	char *str = (char *)jsonez_arena_alloc(pool->arena, len + 1);
+	if (!str) {
+		return NULL;
+	}
+	memcpy(str, key, len);
+	str[len] = '\0';
+
+	pool->slots[slot].key = str;
+	pool->slots[slot].len = len;
+	pool->slots[slot].hash = hash;
+	pool->count++;
+	return str;
+
+}
+
+
+static bool jsonez_parse_intern(jsonez_parser *ps, jsonez_key *key, const char *s, size_t len) {
+
+	if (!ps->keys) {
+		// the rest of the input has every key still to come
+		ps->keys = ps->doc->keys = jsonez_keypool_new(ps->arena, (ps->end - s) + 64);
+	}
+	key->len = (unsigned int)len;
+	key->hash = jsonez_hash(s, len);
+	key->s = ps->keys ? jsonez_keypool_intern(ps->keys, s, key->len, key->hash) : NULL;
+	if (!key->s) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", s);
+		return false;
+	}
+	return true;
+
+}
+
+
+// parsed nodes point at interned keys, array items have none. null when
+// memory runs out, which is reported at p.
+static jsonez *jsonez_parse_create(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p) {
+
+	jsonez *json = jsonez_new(ps->arena);
+	if (!json) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+		return NULL;
+	}
+	if (key) {
+		if (key->term) {
+			*key->term = '\0';
+		}
+		json->key = key->s;
+		json->key_len = key->len;
+		json->key_hash = key->hash;
+		json->flags |= JSONEZ_NODE_KEY_BORROWED;
+	}
+	jsonez_link(ps->arena, parent, NULL, json);
+	return json;
+
+}
+
+
+// arena trees always get their indexes up front so they never need
+// heap memory the arena doesn't know about
+static void jsonez_parse_index(jsonez_parser *ps, jsonez *parent) {
+
+	if ((ps->arena || (ps->flags & JSONEZ_PARSE_INDEX)) && parent->i >= JSONEZ_INDEX_THRESHOLD) {
+		if (parent->type == JSON_ARRAY) {
+			jsonez_items_build(ps->arena, parent);
+		} else {
+			jsonez_index_build(ps->arena, parent);
+		}
+	}
+
+}
+
+
+static const char *jsonez_next_arr(jsonez_parser *ps, const char *p) {
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	if(JSONEZ_AT(ps, p)==',') {
+		p++;
+	}
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	char c = JSONEZ_AT(ps, p);
+	if(c==']') return p;
+	if(c=='{'||c=='['||c=='"'||c=='t'||c=='f'||JSONEZ_NUMBER(c)) return p;
+
+	JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Neverending Array",p);
+	return 0; // error of some king
+
+}
+
+
+static const char *jsonez_next_obj(jsonez_parser *ps, const char *p) {
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	char c = JSONEZ_AT(ps, p);
+	if(c=='\0') return p;
+	if(c=='}'||c==']') return p;
+
+	if(c==',') {
+		p++;
+	} else {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Next item missing",p);
+		return 0; //error of some king
+	}
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	c = JSONEZ_AT(ps, p);
+	if(c=='\0') return p;
+	if(c=='}'||c==']') return p;
+	if(c=='"'||c=='t'||c=='f'||JSONEZ_RAW_KEY(c)) return p;
+
+	JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Unexptected end of file",p);
+	return 0; // error of some king
+
+}
+
+
+static const char *jsonez_skip_key_separator(jsonez_parser *ps, const char *p) {
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	char c = JSONEZ_AT(ps, p);
+	if(c==':' || c=='=') {
+		p++;
+	} else {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Missing ':' key separator",p);
+		return 0; // error of some kind
+	}
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	c = JSONEZ_AT(ps, p);
+	if(c=='"'||c=='t'||c=='f'||JSONEZ_NUMBER(c)||c=='['||c=='{') return p;
+
+	JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Unknow Value type",p);
+	return 0; // error of some kind
+
+}
+
+
+// the character an escape sequence stands for, c is the one after the '\\'
+static char jsonez_unescape(char c) {
+
+	switch(c) {
+		case 'b': return '\b';
+		case 'f': return '\f';
+		case 'n': return '\n';
+		case 'r': return '\r';
+		case 't': return '\t';
+		default: return c; // '"', '\\' and '/' stand for themselves
+	}
+
+}
+
+
+static bool jsonez_scratch_reserve(jsonez_parser *ps, size_t size) {
+
+	if(ps->scratch_size >= size) {
+		return true;
+	}
+
+	size_t grown = ps->scratch_size ? ps->scratch_size * 2 : 256;
+	while(grown < size) {
+		grown *= 2;
+	}
+	char *scratch = (char *)realloc(ps->scratch, grown);
+	if(!scratch) {
+		return false;
+	}
+	ps->scratch = scratch;
+	ps->scratch_size = grown;
+	return true;
+
+}
+
+
+// decodes the escape at p, which is on the '\\', into *d
+static const char *jsonez_scan_escape(jsonez_parser *ps, const char *p, char *d) {
+
+	if(p + 1 >= ps->end || !JSONEZ_ESCAPE(p[1])) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_STRING, "Unknown escape sequence", p + 1);
+		return 0;
+	}
+	*d = jsonez_unescape(p[1]);
+	return p + 2;
+
+}
+
+
+// p is on the opening quote, returns the closing one. plain text is found a
+// vector at a time, a string without escapes comes back pointing into the
+// input and one with escapes is decoded into ps->scratch on the same pass
+static const char *jsonez_scan_string(jsonez_parser *ps, const char *p, const char **str, size_t *len) {
+
+	const char *run = p + 1;
+	p = ps->simd->find_quote(run, ps->end);
+	if(JSONEZ_AT(ps, p) == '"') {
+		*str = run;
+		*len = p - run;
+		return p;
+	}
+
+	size_t used = 0;
+	for(;;) {
+		size_t n = p - run;
+		if(!jsonez_scratch_reserve(ps, used + n + 1)) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", run);
+			return 0;
+		}
+		memcpy(ps->scratch + used, run, n);
+		used += n;
+
+		char c = JSONEZ_AT(ps, p);
+		if(c == '"') {
+			break;
+		}
+		if(c != '\\') {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_STRING, "Neverending Quoted String", p);
+			return 0;
+		}
+		run = jsonez_scan_escape(ps, p, ps->scratch + used++);
+		if(!run) {
+			return 0;
+		}
+		p = ps->simd->find_quote(run, ps->end);
+	}
+
+	*str = ps->scratch;
+	*len = used;
+	return p;
+
+}
+
+
+static const char *jsonez_parse_quote_string(jsonez_parser *ps, char **str, const char *p) {
+
+	const char *s;
+	size_t len;
+	p = jsonez_scan_string(ps, p, &s, &len);
+	if(!p) {
+		return 0;
+	}
+
+	char *d = ps->arena ? (char *)jsonez_arena_alloc(ps->arena, len+1) : (char *)malloc(len+1);
+	if (!d) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+		return 0;
+	}
+	memcpy(d, s, len);
+	d[len] = '\0';
+	*str = d;
+	return p+1;
+
+}
+
+
+// in situ strings are unescaped where they are and terminated over the
+// closing quote, or earlier if escapes made them shorter
+static const char *jsonez_parse_quote_insitu(jsonez_parser *ps, char **str, const char *p) {
+
+	char *s = (char *)p+1;
+	char *d = s;
+	const char *run = s;
+	for(;;) {
+		p = ps->simd->find_quote(run, ps->end);
+		if(d != run) {
+			memmove(d, run, p - run);
+		}
+		d += p - run;
+
+		char c = JSONEZ_AT(ps, p);
+		if(c == '"') {
+			break;
+		}
+		if(c != '\\') {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_STRING, "Neverending Quoted String", p);
+			return 0;
+		}
+		run = jsonez_scan_escape(ps, p, d++);
+		if(!run) {
+			return 0;
+		}
+	}
+
+	*d = '\0';
+	*str = s;
+	return p+1;
+
+}
+
+
+static const char *jsonez_parse_quote_key(jsonez_parser *ps, jsonez_key *key, const char *p) {
+
+	if(ps->flags & JSONEZ_PARSE_INSITU) {
+		p = jsonez_parse_quote_insitu(ps, &key->s, p);
+		if(p) {
+			key->len = (unsigned int)strlen(key->s);
+			key->hash = jsonez_hash(key->s, key->len);
+		}
+		return p;
+	}
+
+	const char *s;
+	size_t len;
+	p = jsonez_scan_string(ps, p, &s, &len);
+	if(!p) {
+		return 0;
+	}
+
+	if (!jsonez_parse_intern(ps, key, s, len)) {
+		return 0;
+	}
+	return p+1;
+
+}
+
+
+static const char *jsonez_parse_raw_key(jsonez_parser *ps, jsonez_key *key, const char *p) {
+
+	const char *s = p;
+	int len = 0;
+
+	while(p < ps->end && JSONEZ_RAW_KEY(*p)) {
+		p++;
+		len++;
+	}
+
+	p = jsonez_skip_whitespace(ps, p);
+
+	char c = JSONEZ_AT(ps, p);
+	if(c == ':' || c == '=') {
+		// got a key
+		if(ps->flags & JSONEZ_PARSE_INSITU) {
+			// the terminator may land on the separator, so it waits
+			key->s = (char *)s;
+			key->len = len;
+			key->hash = jsonez_hash(s, len);
+			key->term = (char *)s + len;
+		} else if (!jsonez_parse_intern(ps, key, s, len)) {
+			return 0;
+		}
+		return p;
+	} 
+	
+	JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Missing ':' key separator", p);
+	return 0;
+}
+
+
+static const char *jsonez_parse_bool_value(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p) {
+
+	jsonez *json = jsonez_parse_create(ps, parent, key, p);
+	if (!json) {
+		return 0;
+	}
+	size_t left = ps->end - p;
+
+	if(left >= 4 && !memcmp(p, "true", 4)) {
+		json->type = JSON_BOOL;
+		json->i = 1;
+		return p+4;
+	}
+	if(left >= 5 && !memcmp(p, "false", 5)) {
+		json->type = JSON_BOOL;
+		json->i = 0;
+		return p+5;
+	}
+
+	JSONEZ_ERROR(ps, JSONEZ_ERROR_LITERAL, "Unknow Value", p);
+	return 0;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Number parsing
+//
+// decimal to double without strtod, so no locale, no errno and no copy of
+// the input. up to 19 significant digits go through the Eisel-Lemire
+// algorithm, which is exact with a 128 bit power of five table. longer
+// numbers whose truncation is ambiguous fall back to a big decimal.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define JSONEZ_POW5_MIN -342
+#define JSONEZ_POW5_MAX 308
+
+// 5^q for q in -342..308, normalized so the top bit is set and truncated
+// (rounded up for negative q) to 128 bits, high half first
+static const unsigned long long jsonez_pow5[] = {
+	0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL,
+	0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+	0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL,
+	0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+	0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL,
+	0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+	0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL,
+	0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+	0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL,
+	0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+	0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL,
+	0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+	0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL,
+	0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+	0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL,
+	0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+	0x84a57695fe98746dULL, 0x014bb630f7604b57ULL,
+	0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+	0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL,
+	0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+	0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL,
+	0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+	0xfd00b897478238d0ULL, 0x8920b098955522b4ULL,
+	0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+	0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL,
+	0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+	0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL,
+	0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+	0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL,
+	0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+	0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL,
+	0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+	0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL,
+	0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+	0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL,
+	0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+	0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL,
+	0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+	0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL,
+	0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+	0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL,
+	0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+	0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL,
+	0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+	0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL,
+	0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+	0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL,
+	0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+	0xa37fce126597973cULL, 0xe50ff107bab528a0ULL,
+	0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+	0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL,
+	0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+	0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL,
+	0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+	0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL,
+	0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+	0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL,
+	0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+	0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL,
+	0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+	0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL,
+	0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+	0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL,
+	0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+	0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL,
+	0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+	0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL,
+	0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+	0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL,
+	0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+	0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL,
+	0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+	0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL,
+	0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+	0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL,
+	0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+	0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL,
+	0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+	0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL,
+	0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+	0xc987434744ac874eULL, 0xa327ffb266b56220ULL,
+	0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+	0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL,
+	0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+	0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL,
+	0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+	0xc0314325637a1939ULL, 0xfa911155fefb5308ULL,
+	0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+	0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL,
+	0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+	0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL,
+	0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+	0xb749faed14125d36ULL, 0xcef980ec671f667bULL,
+	0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+	0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL,
+	0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+	0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL,
+	0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+	0xaecc49914078536dULL, 0x58fae9f773886e18ULL,
+	0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+	0x888f99797a5e012dULL, 0x6d8406c952429603ULL,
+	0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+	0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL,
+	0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+	0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL,
+	0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+	0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL,
+	0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+	0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL,
+	0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+	0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL,
+	0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+	0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL,
+	0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+	0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL,
+	0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+	0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL,
+	0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+	0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL,
+	0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+	0xb913179899f68584ULL, 0x28e2557b59846e3fULL,
+	0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+	0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL,
+	0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+	0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL,
+	0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+	0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL,
+	0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+	0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL,
+	0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+	0xd77485cb25823ac7ULL, 0x7d633293366b828bULL,
+	0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+	0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL,
+	0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+	0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL,
+	0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+	0xcd795be870516656ULL, 0x67902e276c921f8bULL,
+	0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+	0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL,
+	0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+	0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL,
+	0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+	0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL,
+	0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+	0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL,
+	0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+	0xef340a98172aace4ULL, 0x86fb897116c87c34ULL,
+	0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+	0xbae0a846d2195712ULL, 0x8974836059cca109ULL,
+	0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+	0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL,
+	0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+	0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL,
+	0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+	0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL,
+	0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+	0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL,
+	0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+	0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL,
+	0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+	0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL,
+	0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+	0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL,
+	0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+	0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL,
+	0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+	0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL,
+	0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+	0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL,
+	0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+	0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL,
+	0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+	0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL,
+	0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+	0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL,
+	0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+	0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL,
+	0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+	0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL,
+	0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+	0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL,
+	0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+	0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL,
+	0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+	0x8c974f7383725573ULL, 0x1e414218c73a13fbULL,
+	0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+	0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL,
+	0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+	0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL,
+	0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+	0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL,
+	0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+	0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL,
+	0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+	0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL,
+	0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+	0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL,
+	0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+	0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL,
+	0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+	0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL,
+	0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+	0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL,
+	0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+	0xbe89523386091465ULL, 0xf6bbb397f1135823ULL,
+	0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+	0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL,
+	0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+	0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL,
+	0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+	0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL,
+	0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+	0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL,
+	0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+	0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL,
+	0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+	0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL,
+	0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+	0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL,
+	0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+	0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL,
+	0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+	0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL,
+	0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+	0x811ccc668829b887ULL, 0x0806357d5a3f525fULL,
+	0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+	0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL,
+	0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+	0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL,
+	0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+	0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL,
+	0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+	0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL,
+	0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+	0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL,
+	0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+	0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL,
+	0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+	0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL,
+	0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+	0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL,
+	0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+	0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL,
+	0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+	0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL,
+	0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+	0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL,
+	0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+	0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL,
+	0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+	0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL,
+	0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+	0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL,
+	0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+	0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL,
+	0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+	0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL,
+	0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+	0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL,
+	0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+	0xc24452da229b021bULL, 0xfbe85badce996168ULL,
+	0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+	0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL,
+	0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+	0xed246723473e3813ULL, 0x290123e9aab23b68ULL,
+	0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+	0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL,
+	0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+	0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL,
+	0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+	0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL,
+	0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+	0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL,
+	0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+	0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL,
+	0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+	0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL,
+	0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+	0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+	0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+	0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+	0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+	0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+	0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+	0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+	0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+	0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+	0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+	0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+	0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+	0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+	0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+	0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+	0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+	0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+	0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+	0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+	0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+	0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+	0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+	0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+	0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+	0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+	0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+	0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+	0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+	0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+	0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+	0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+	0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+	0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+	0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+	0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+	0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+	0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+	0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+	0xc612062576589ddaULL, 0x95364afe032a819eULL,
+	0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+	0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+	0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+	0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+	0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+	0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+	0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+	0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+	0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+	0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+	0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+	0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+	0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+	0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+	0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+	0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+	0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+	0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+	0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+	0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+	0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+	0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+	0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+	0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+	0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+	0x8000000000000000ULL, 0x0000000000000000ULL,
+	0xa000000000000000ULL, 0x0000000000000000ULL,
+	0xc800000000000000ULL, 0x0000000000000000ULL,
+	0xfa00000000000000ULL, 0x0000000000000000ULL,
+	0x9c40000000000000ULL, 0x0000000000000000ULL,
+	0xc350000000000000ULL, 0x0000000000000000ULL,
+	0xf424000000000000ULL, 0x0000000000000000ULL,
+	0x9896800000000000ULL, 0x0000000000000000ULL,
+	0xbebc200000000000ULL, 0x0000000000000000ULL,
+	0xee6b280000000000ULL, 0x0000000000000000ULL,
+	0x9502f90000000000ULL, 0x0000000000000000ULL,
+	0xba43b74000000000ULL, 0x0000000000000000ULL,
+	0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+	0x9184e72a00000000ULL, 0x0000000000000000ULL,
+	0xb5e620f480000000ULL, 0x0000000000000000ULL,
+	0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+	0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+	0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+	0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+	0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+	0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+	0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+	0x878678326eac9000ULL, 0x0000000000000000ULL,
+	0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+	0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+	0x84595161401484a0ULL, 0x0000000000000000ULL,
+	0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+	0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+	0x813f3978f8940984ULL, 0x4000000000000000ULL,
+	0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+	0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+	0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+	0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+	0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+	0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+	0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+	0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+	0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+	0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+	0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+	0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL,
+	0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+	0xb7abc627050305adULL, 0xf14a3d9e40000000ULL,
+	0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+	0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL,
+	0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+	0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL,
+	0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+	0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL,
+	0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+	0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL,
+	0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+	0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL,
+	0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+	0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL,
+	0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+	0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL,
+	0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+	0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL,
+	0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+	0x9f4f2726179a2245ULL, 0x01d762422c946590ULL,
+	0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+	0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL,
+	0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+	0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL,
+	0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+	0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL,
+	0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+	0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL,
+	0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+	0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL,
+	0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+	0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL,
+	0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+	0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL,
+	0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+	0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL,
+	0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+	0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL,
+	0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+	0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL,
+	0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+	0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL,
+	0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+	0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL,
+	0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+	0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL,
+	0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+	0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL,
+	0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+	0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL,
+	0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+	0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL,
+	0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+	0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL,
+	0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+	0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL,
+	0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+	0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL,
+	0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+	0x924d692ca61be758ULL, 0x593c2626705f9c56ULL,
+	0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+	0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL,
+	0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+	0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL,
+	0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+	0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL,
+	0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+	0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL,
+	0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+	0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL,
+	0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+	0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL,
+	0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+	0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL,
+	0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+	0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL,
+	0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+	0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL,
+	0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+	0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL,
+	0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+	0x9ae757596946075fULL, 0x3375788de9b06958ULL,
+	0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+	0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL,
+	0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+	0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL,
+	0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+	0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL,
+	0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+	0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL,
+	0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+	0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL,
+	0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+	0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL,
+	0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+	0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL,
+	0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+	0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL,
+	0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+	0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL,
+	0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+	0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL,
+	0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+	0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL,
+	0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+	0x802221226be55a64ULL, 0xc2494954da2c9789ULL,
+	0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+	0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL,
+	0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+	0x9c69a97284b578d7ULL, 0xff2a760414536efbULL,
+	0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+	0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL,
+	0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+	0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL,
+	0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+	0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL,
+	0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+	0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL,
+	0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+	0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL,
+	0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+	0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL,
+	0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+	0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL,
+	0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+	0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL,
+	0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+	0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL,
+	0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+	0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL,
+	0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+	0xa59bc234db398c25ULL, 0x43fab9837e699095ULL,
+	0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+	0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL,
+	0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+	0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL,
+	0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+	0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL,
+	0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+	0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL,
+	0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+	0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL,
+	0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+	0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL,
+	0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+	0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL,
+	0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+	0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL,
+	0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+	0x8fa475791a569d10ULL, 0xf96e017d694487bcULL,
+	0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+	0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL,
+	0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+	0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL,
+	0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+	0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL,
+	0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+	0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL,
+	0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+	0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL,
+	0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+	0x82a45b450226b39cULL, 0xecc0024661173473ULL,
+	0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+	0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL,
+	0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+	0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL,
+	0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+	0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL,
+	0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+	0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL,
+	0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+	0x98165af37b2153deULL, 0xc3727a337a8b704aULL,
+	0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+	0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL,
+	0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+	0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL,
+	0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+	0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL,
+	0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+	0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL,
+	0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+	0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL,
+	0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+	0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL,
+	0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+	0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL,
+	0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+	0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL,
+	0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+	0x83ea2b892091e44dULL, 0x934aed0aab460432ULL,
+	0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+	0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL,
+	0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+	0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL,
+	0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+	0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL,
+	0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+	0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL,
+	0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+	0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL,
+	0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+	0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL,
+	0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+	0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL,
+	0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+	0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL,
+	0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+	0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL,
+	0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+	0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL,
+	0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+	0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL,
+	0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+	0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL,
+	0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+	0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL,
+	0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+	0x8533285c936b35deULL, 0xd53a88958f87275fULL,
+	0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+	0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL,
+	0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+	0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL,
+	0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+	0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL,
+	0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+	0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL,
+	0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+	0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL,
+	0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+	0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL,
+	0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+	0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL,
+	0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+	0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL,
+	0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+	0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL,
+	0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+	0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL,
+	0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+	0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL,
+	0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+	0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL,
+	0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+	0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL,
+	0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+	0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL,
+	0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+	0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL,
+	0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+	0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL,
+	0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+	0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL,
+	0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+	0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL,
+	0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+	0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL,
+	0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+	0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL,
+	0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+	0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL,
+	0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+	0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL,
+	0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+	0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL,
+	0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+	0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL,
+	0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+	0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL,
+};
+
+
+static const double jsonez_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+static int jsonez_clz(unsigned long long x) {
+#if defined(_MSC_VER)
+	unsigned long i;
+	_BitScanReverse64(&i, x);
+	return 63 - (int)i;
+#else
+	return __builtin_clzll(x);
+#endif
+}
+
+
+static unsigned long long jsonez_mul128(unsigned long long a, unsigned long long b, unsigned long long *hi) {
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 r = (unsigned __int128)a * b;
+	*hi = (unsigned long long)(r >> 64);
+	return (unsigned long long)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return _umul128(a, b, hi);
+#else
+	unsigned long long al = a & 0xFFFFFFFF, ah = a >> 32;
+	unsigned long long bl = b & 0xFFFFFFFF, bh = b >> 32;
+	unsigned long long ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+	unsigned long long mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+	*hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return (mid << 32) | (ll & 0xFFFFFFFF);
+#endif
+}
+
+
+// w * 10^q as the bits of a positive double, w is not zero
+static unsigned long long jsonez_eisel_lemire(unsigned long long w, int q) {
+
+	if (q < JSONEZ_POW5_MIN) {
+		return 0;
+	}
+	if (q > JSONEZ_POW5_MAX) {
+		return 0x7FFull << 52;
+	}
+
+	int lz = jsonez_clz(w);
+	w <<= lz;
+
+	// 55 bits are needed, the second half of the power only matters when the
+	// bits below those are all ones
+	const unsigned long long *pow5 = jsonez_pow5 + 2 * (q - JSONEZ_POW5_MIN);
+	unsigned long long hi, lo = jsonez_mul128(w, pow5[0], &hi);
+	if ((hi & 0x1FF) == 0x1FF) {
+		unsigned long long hi2;
+		jsonez_mul128(w, pow5[1], &hi2);
+		lo += hi2;
+		if (hi2 > lo) {
+			hi++;
+		}
+	}
+
+	int upper = (int)(hi >> 63);
+	int shift = upper + 9;
+	unsigned long long mantissa = hi >> shift;
+	int power2 = (((152170 + 65536) * q) >> 16) + 63 + upper - lz + 1023;
+
+	if (power2 <= 0) {
+		// subnormal, it might round back up into the normals
+		if (-power2 + 1 >= 64) {
+			return 0;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		return mantissa < (1ull << 52) ? mantissa : (1ull << 52) | (mantissa & ((1ull << 52) - 1));
+	}
+
+	// exactly halfway between two doubles has to round to even
+	if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == hi) {
+		mantissa &= ~1ull;
+	}
+
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= (2ull << 52)) {
+		mantissa = 1ull << 52;
+		power2++;
+	}
+	if (power2 >= 0x7FF) {
+		return 0x7FFull << 52;
+	}
+	return (mantissa & ((1ull << 52) - 1)) | ((unsigned long long)power2 << 52);
+
+}
+
+
+// the slow path, decimal digits shifted by powers of two until the binary
+// exponent and mantissa fall out. only used for very long numbers
+#define JSONEZ_DECIMAL_DIGITS 800
+
+typedef struct jsonez_decimal {
+
+	unsigned char d[JSONEZ_DECIMAL_DIGITS + 20]; // digit values, the slack is for left shifts
+	int nd; // digits used
+	int dp; // the decimal point is after this many digits
+	bool trunc; // nonzero digits were dropped
+
+} jsonez_decimal;
+
+
+static void jsonez_decimal_trim(jsonez_decimal *a) {
+
+	while (a->nd > 0 && a->d[a->nd - 1] == 0) {
+		a->nd--;
+	}
+	if (a->nd == 0) {
+		a->dp = 0;
+	}
+
+}
+
+
+static void jsonez_decimal_right_shift(jsonez_decimal *a, int k) {
+
+	int r = 0, w = 0;
+	unsigned long long n = 0, mask = (1ull << k) - 1;
+
+	// read enough digits to get something out
+	for (; (n >> k) == 0; r++) {
+		if (r >= a->nd) {
+			if (n == 0) {
+				a->nd = 0;
+				return;
+			}
+			while ((n >> k) == 0) {
+				n *= 10;
+				r++;
+			}
+			break;
+		}
+		n = n * 10 + a->d[r];
+	}
+	a->dp -= r - 1;
+
+	for (; r < a->nd; r++) {
+		a->d[w++] = (unsigned char)(n >> k);
+		n = (n & mask) * 10 + a->d[r];
+	}
+	while (n > 0) {
+		unsigned char digit = (unsigned char)(n >> k);
+		if (w < JSONEZ_DECIMAL_DIGITS) {
+			a->d[w++] = digit;
+		} else if (digit > 0) {
+			a->trunc = true;
+		}
+		n = (n & mask) * 10;
+	}
+	a->nd = w;
+	jsonez_decimal_trim(a);
+
+}
+
+
+static void jsonez_decimal_left_shift(jsonez_decimal *a, int k) {
+
+	// 2^60 adds at most 19 digits, write them from the right with that much
+	// room and slide the result down afterwards
+	int w = a->nd + 19;
+	unsigned long long n = 0;
+	for (int r = a->nd - 1; r >= 0; r--) {
+		n += (unsigned long long)a->d[r] << k;
+		a->d[--w] = (unsigned char)(n % 10);
+		n /= 10;
+	}
+	while (n > 0) {
+		a->d[--w] = (unsigned char)(n % 10);
+		n /= 10;
+	}
+
+	int delta = 19 - w;
+	memmove(a->d, a->d + w, a->nd + delta);
+	a->nd += delta;
+	a->dp += delta;
+	if (a->nd > JSONEZ_DECIMAL_DIGITS) {
+		for (int i = JSONEZ_DECIMAL_DIGITS; i < a->nd; i++) {
+			a->trunc |= a->d[i] != 0;
+		}
+		a->nd = JSONEZ_DECIMAL_DIGITS;
+	}
+	jsonez_decimal_trim(a);
+
+}
+
+
+static void jsonez_decimal_shift(jsonez_decimal *a, int k) {
+
+	if (a->nd == 0) {
+		return;
+	}
+	for (; k > 60; k -= 60) {
+		jsonez_decimal_left_shift(a, 60);
+	}
+	for (; k < -60; k += 60) {
+		jsonez_decimal_right_shift(a, 60);
+	}
+	if (k > 0) {
+		jsonez_decimal_left_shift(a, k);
+	} else if (k < 0) {
+		jsonez_decimal_right_shift(a, -k);
+	}
+
+}
+
+
+static unsigned long long jsonez_decimal_round(jsonez_decimal *a) {
+
+	if (a->dp > 20) {
+		return ~0ull;
+	}
+
+	int i = 0;
+	unsigned long long n = 0;
+	for (; i < a->dp && i < a->nd; i++) {
+		n = n * 10 + a->d[i];
+	}
+	for (; i < a->dp; i++) {
+		n *= 10;
+	}
+
+	// halfway rounds to even, unless something was dropped past the half
+	int nd = a->dp;
+	if (nd >= 0 && nd < a->nd) {
+		bool up = a->d[nd] >= 5;
+		if (a->d[nd] == 5 && nd + 1 == a->nd) {
+			up = a->trunc || (nd > 0 && (a->d[nd - 1] & 1));
+		}
+		n += up;
+	}
+	return n;
+
+}
+
+
+// the digits of the number text, sign already stripped, as double bits
+static unsigned long long jsonez_decimal_bits(const char *p, const char *end) {
+
+	static const int steps[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+
+	jsonez_decimal a;
+	a.nd = 0;
+	a.dp = 0;
+	a.trunc = false;
+
+	bool point = false;
+	for (; p < end; p++) {
+		if (*p == '.') {
+			point = true;
+		} else if (JSONEZ_BETWEEN(*p, '0', '9')) {
+			if (*p == '0' && a.nd == 0) {
+				a.dp -= point; // leading zeros only move the point
+			} else if (a.nd < JSONEZ_DECIMAL_DIGITS) {
+				a.d[a.nd++] = (unsigned char)(*p - '0');
+			} else if (*p != '0') {
+				a.trunc = true;
+			}
+			a.dp += !point && a.nd > 0;
+		} else {
+			break;
+		}
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool neg = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+		int e = 0;
+		for (; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+			e = e < 100000 ? e * 10 + (*p - '0') : e;
+		}
+		a.dp += neg ? -e : e;
+	}
+	jsonez_decimal_trim(&a);
+
+	if (a.nd == 0 || a.dp < -330) {
+		return 0;
+	}
+	if (a.dp > 310) {
+		return 0x7FFull << 52;
+	}
+
+	// scale into [0.5, 1) and count the powers of two that took
+	int exp = 0;
+	while (a.dp > 0) {
+		int n = a.dp >= 9 ? 27 : steps[a.dp];
+		jsonez_decimal_shift(&a, -n);
+		exp += n;
+	}
+	while (a.dp < 0 || (a.dp == 0 && a.d[0] < 5)) {
+		int n = -a.dp >= 9 ? 27 : steps[-a.dp];
+		jsonez_decimal_shift(&a, n);
+		exp -= n;
+	}
+
+	// [0.5, 1) to [1, 2), then up to the smallest exponent
+	exp--;
+	if (exp < -1022) {
+		jsonez_decimal_shift(&a, exp + 1022);
+		exp = -1022;
+	}
+	if (exp + 1023 >= 0x7FF) {
+		return 0x7FFull << 52;
+	}
+
+	jsonez_decimal_shift(&a, 53);
+	unsigned long long mantissa = jsonez_decimal_round(&a);
+	if (mantissa == (2ull << 52)) {
+		mantissa >>= 1;
+		if (++exp + 1023 >= 0x7FF) {
+			return 0x7FFull << 52;
+		}
+	}
+	if (!(mantissa & (1ull << 52))) {
+		exp = -1023; // subnormal
+	}
+	return (mantissa & ((1ull << 52) - 1)) | ((unsigned long long)(exp + 1023) << 52);
+
+}
+
+
+// parses a number starting at p into json and stops at the first byte that
+// can't continue it, null when there isn't a number there at all
+static const char *jsonez_scan_number(const char *p, const char *end, jsonez *json) {
+
+	bool neg = p < end && *p == '-';
+	p += p < end && (*p == '-' || *p == '+');
+	const char *digits = p;
+
+	// the first 19 significant digits fit w, the rest only move the exponent
+	unsigned long long w = 0;
+	int kept = 0;
+	long long q = 0;
+	bool trunc = false, any = false, integral = true;
+	unsigned int last = 0; // the 20th digit, a uint64 can have that many
+	for (; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+		any = true;
+		if (kept < 19) {
+			w = w * 10 + (*p - '0');
+			kept += w != 0;
+		} else {
+			if (q++ == 0) {
+				last = *p - '0';
+			}
+			trunc |= *p != '0';
+		}
+	}
+	if (p < end && *p == '.') {
+		integral = false;
+		for (p++; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+			any = true;
+			if (kept < 19) {
+				w = w * 10 + (*p - '0');
+				kept += w != 0;
+				q--;
+			} else {
+				trunc |= *p != '0';
+			}
+		}
+	}
+	if (!any) {
+		return 0;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		integral = false;
+		p++;
+		bool eneg = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+		if (!(p < end && JSONEZ_BETWEEN(*p, '0', '9'))) {
+			return 0;
+		}
+		long long e = 0;
+		for (; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+			e = e < 100000 ? e * 10 + (*p - '0') : e;
+		}
+		q += eneg ? -e : e;
+	}
+
+	q = q < -100000 ? -100000 : q > 100000 ? 100000 : q;
+
+	double d;
+	if (w == 0) {
+		d = 0;
+	} else if (!trunc && q == 0) {
+		d = (double)w;
+	} else if (!trunc && w <= (1ull << 53) && q >= -22 && q <= 22) {
+		// both exact, so one correctly rounded operation
+		d = q < 0 ? (double)w / jsonez_pow10[-q] : (double)w * jsonez_pow10[q];
+	} else {
+		unsigned long long bits = jsonez_eisel_lemire(w, (int)q);
+		if (trunc && bits != jsonez_eisel_lemire(w + 1, (int)q)) {
+			bits = jsonez_decimal_bits(digits, p);
+		}
+		memcpy(&d, &bits, sizeof(d));
+	}
+	json->n = neg ? -d : d;
+
+	if (integral && (q == 0 || (q == 1 && w <= (UINT64_MAX - last) / 10))) {
+		uint64_t u = q ? w * 10 + last : w;
+		if (neg && u <= (uint64_t)INT64_MAX + 1) {
+			json->i64 = (int64_t)(0 - u);
+			json->flags |= JSONEZ_NODE_INT;
+		} else if (!neg) {
+			json->u64 = u;
+			json->flags |= u <= INT64_MAX ? JSONEZ_NODE_INT : JSONEZ_NODE_UINT;
+		}
+	}
+	return p;
+
+}
+
+
+static const char *jsonez_parse_number_value(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p) {
+
+	jsonez *json = jsonez_parse_create(ps, parent, key, p);
+	if (!json) {
+		return 0;
+	}
+
+	const char *e = jsonez_scan_number(p, ps->end, json);
+	// n - n is only nonzero for infinity, too big is not a number we can keep
+	if(!e || (e < ps->end && JSONEZ_NUMBER(*e)) || json->n - json->n != 0) {
+		json->flags &= ~(JSONEZ_NODE_INT | JSONEZ_NODE_UINT);
+		json->index = NULL;
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_NUMBER, "Invalid Number Format", p);
+		return 0;
+	}
+	json->type = JSON_NUMBER;
+	return e;
+
+}
+
+
+static const char *jsonez_parse_string_value(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p) {
+
+	jsonez *json = jsonez_parse_create(ps, parent, key, p);
+	if (!json) {
+		return 0;
+	}
+	if(ps->flags & JSONEZ_PARSE_INSITU) {
+		p = jsonez_parse_quote_insitu(ps, &json->s, p);
+		json->flags |= JSONEZ_NODE_STR_BORROWED;
+	} else {
+		p = jsonez_parse_quote_string(ps, &json->s, p);
+	}
+	json->type = JSON_STRING;
+	if(p) {
+		return p;
+	}
+
+	return 0; // TODO - error
+
+}
+
+
+static bool jsonez_parse_push(jsonez_parser *ps, jsonez *node, jsonez_frame_kind kind) {
+
+	if (ps->depth == ps->stack_size) {
+		size_t size = ps->stack_size * 2;
+		jsonez_frame *stack = (jsonez_frame *)malloc(size * sizeof(jsonez_frame));
+		if (!stack) {
+			return false;
+		}
+		memcpy(stack, ps->stack, ps->depth * sizeof(jsonez_frame));
+		if (ps->stack != ps->frames) {
+			free(ps->stack);
+		}
+		ps->stack = stack;
+		ps->stack_size = size;
+	}
+	ps->stack[ps->depth].node = node;
+	ps->stack[ps->depth].kind = kind;
+	// an array starts out as if after an item, so one leading comma is skipped
+	ps->stack[ps->depth].expect = kind == JSONEZ_IN_ARRAY ? JSONEZ_EXPECT_NEXT : JSONEZ_EXPECT_KEY;
+	ps->depth++;
+	return true;
+
+}
+
+
+// what a callback returned, a false one is remembered so the stop isn't
+// taken for a syntax error
+static bool jsonez_sax_go(jsonez_parser *ps, bool go) {
+
+	ps->stopped |= !go;
+	return go;
+
+}
+
+
+// a container ends, as a typed node or an event
+static bool jsonez_parse_close(jsonez_parser *ps, jsonez_frame *top) {
+
+	jsonez_handler *h = ps->sax;
+	if (h) {
+		if (top->kind == JSONEZ_IN_ARRAY) {
+			return jsonez_sax_go(ps, !h->end_array || h->end_array(h->user));
+		}
+		return jsonez_sax_go(ps, !h->end_object || h->end_object(h->user));
+	}
+
+	bool array = top->kind == JSONEZ_IN_ARRAY || top->kind == JSONEZ_IN_SLICE;
+	top->node->type = array ? JSON_ARRAY : JSON_OBJ;
+	jsonez_parse_index(ps, top->node);
+	return true;
+
+}
+
+
+static bool jsonez_parse_open(jsonez_parser *ps, jsonez *parent, jsonez_key *key, char c, const char *p) {
+
+	jsonez_handler *h = ps->sax;
+	jsonez *child = NULL;
+	if (h) {
+		bool go = c == '{' ? !h->begin_object || h->begin_object(h->user) :
+			!h->begin_array || h->begin_array(h->user);
+		if (!jsonez_sax_go(ps, go)) {
+			return false;
+		}
+	} else if (!(child = jsonez_parse_create(ps, parent, key, p))) {
+		return false;
+	}
+	if (!jsonez_parse_push(ps, child, c == '{' ? JSONEZ_IN_OBJECT : JSONEZ_IN_ARRAY)) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+		return false;
+	}
+	return true;
+
+}
+
+
+// p is on the opening quote, returns the closing one. the escapes are
+// checked but not decoded.
+static const char *jsonez_check_string(jsonez_parser *ps, const char *p) {
+
+	for (p = ps->simd->find_quote(p + 1, ps->end);; p = ps->simd->find_quote(p + 2, ps->end)) {
+		char c = JSONEZ_AT(ps, p);
+		if (c == '"') {
+			return p;
+		}
+		if (c != '\\') {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_STRING, "Neverending Quoted String", p);
+			return 0;
+		}
+		if (p + 1 >= ps->end || !JSONEZ_ESCAPE(p[1])) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_STRING, "Unknown escape sequence", p + 1);
+			return 0;
+		}
+	}
+
+}
+
+
+// accepts what jsonez_scan_number does without working out the value,
+// unless it could be too big for a double
+static const char *jsonez_check_number(const char *p, const char *end) {
+
+	const char *s = p;
+	p += p < end && (*p == '-' || *p == '+');
+	bool any = false;
+	long long mag = 0; // digits before the point, leading zeros aside
+	for (; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+		any = true;
+		mag += mag || *p != '0';
+	}
+	if (p < end && *p == '.') {
+		for (p++; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+			any = true;
+		}
+	}
+	if (!any) {
+		return 0;
+	}
+
+	long long e = 0;
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool eneg = p < end && *p == '-';
+		p += p < end && (*p == '-' || *p == '+');
+		if (!(p < end && JSONEZ_BETWEEN(*p, '0', '9'))) {
+			return 0;
+		}
+		for (; p < end && JSONEZ_BETWEEN(*p, '0', '9'); p++) {
+			e = e < 100000 ? e * 10 + (*p - '0') : e;
+		}
+		e = eneg ? -e : e;
+	}
+
+	// below 10^308 is always finite, past that only converting tells
+	if (mag + e > 308) {
+		jsonez num;
+		num.flags = 0;
+		p = jsonez_scan_number(s, end, &num);
+		return num.n - num.n != 0 ? 0 : p;
+	}
+	return p;
+
+}
+
+
+// keys and scalars as events, they are read the same way as for the tree
+// but only ever looked at in place
+static const char *jsonez_sax_key(jsonez_parser *ps, const char *p) {
+
+	const char *s = p;
+	size_t len = 0;
+	if (*p == '"' && ps->validate) {
+		p = jsonez_check_string(ps, p);
+		if (!p) {
+			return 0;
+		}
+		p++;
+	} else if (*p == '"') {
+		p = jsonez_scan_string(ps, p, &s, &len);
+		if (!p) {
+			return 0;
+		}
+		p++;
+	} else {
+		while (p < ps->end && JSONEZ_RAW_KEY(*p)) {
+			p++;
+		}
+		len = p - s;
+		s = len ? s : NULL;
+	}
+
+	p = jsonez_skip_key_separator(ps, p);
+	if (!p) {
+		return 0;
+	}
+	jsonez_handler *h = ps->sax;
+	return jsonez_sax_go(ps, !h->key || h->key(h->user, s, len)) ? p : 0;
+
+}
+
+
+static const char *jsonez_sax_value(jsonez_parser *ps, const char *p) {
+
+	jsonez_handler *h = ps->sax;
+	char c = *p;
+	bool go;
+
+	if (c == 't' || c == 'f') {
+		bool value = c == 't';
+		size_t n = value ? 4 : 5;
+		if ((size_t)(ps->end - p) < n || memcmp(p, value ? "true" : "false", n)) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_LITERAL, "Unknow Value", p);
+			return 0;
+		}
+		go = !h->boolean || h->boolean(h->user, value);
+		p += n;
+	} else if (ps->validate) {
+		const char *e = c == '"' ? jsonez_check_string(ps, p) : jsonez_check_number(p, ps->end);
+		if (c == '"') {
+			return e ? e + 1 : 0;
+		}
+		if (!e || (e < ps->end && JSONEZ_NUMBER(*e))) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_NUMBER, "Invalid Number Format", p);
+			return 0;
+		}
+		return e;
+	} else if (c == '"') {
+		const char *s;
+		size_t len;
+		p = jsonez_scan_string(ps, p, &s, &len);
+		if (!p) {
+			return 0;
+		}
+		go = !h->string || h->string(h->user, s, len);
+		p++;
+	} else {
+		jsonez *num = &ps->number;
+		num->flags = 0;
+		const char *e = jsonez_scan_number(p, ps->end, num);
+		if (!e || (e < ps->end && JSONEZ_NUMBER(*e)) || num->n - num->n != 0) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_NUMBER, "Invalid Number Format", p);
+			return 0;
+		}
+		go = !h->number || h->number(h->user, num->n, p, e - p);
+		p = e;
+	}
+	return jsonez_sax_go(ps, go) ? p : 0;
+
+}
+
+
+// parses the items of parent, which p is just inside of, and of everything
+// nested in it. containers go on ps->stack instead of recursing so nesting
+// depth costs heap, not call stack. returns just past parent's end. with
+// ps->sax set the same walk sends events and parent is null.
+static const char *jsonez_parse_values(jsonez_parser *ps, jsonez *parent, jsonez_frame_kind kind, const char *p) {
+
+	ps->depth = 0;
+	jsonez_parse_push(ps, parent, kind);
+	p = jsonez_skip_whitespace(ps, p);
+
+	while (ps->depth) {
+
+		jsonez_frame *top = &ps->stack[ps->depth - 1];
+		parent = top->node;
+		char c = JSONEZ_AT(ps, p);
+		if (!c) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Syntax Error", p);
+			return 0; // error of some kind
+		}
+
+		// objects and the root start each item with a key
+		jsonez_key key = {0};
+		jsonez_key *item_key = NULL;
+		bool keyed = top->kind == JSONEZ_IN_ROOT || top->kind == JSONEZ_IN_OBJECT;
+		bool closed = false;
+		if (top->kind == JSONEZ_IN_OBJECT && c == '}') {
+			if (!jsonez_parse_close(ps, top)) {
+				return 0;
+			}
+			p++;
+			closed = true;
+		} else if (keyed && ps->sax) {
+			// like the tree, an item without a key gets a null one
+			p = jsonez_sax_key(ps, p);
+			if (!p) {
+				return 0;
+			}
+			c = *p;
+		} else if (keyed) {
+			if(JSONEZ_RAW_KEY(c)) {
+				p = jsonez_parse_raw_key(ps, &key, p);
+			} else if(c=='"') {
+				p = jsonez_parse_quote_key(ps, &key, p);
+			}
+			if(!p) {
+				if (top->kind == JSONEZ_IN_ROOT) JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Error parsing key", p);
+				return 0;
+			}
+
+			p = jsonez_skip_key_separator(ps, p);
+			if(!p) {
+				if (top->kind == JSONEZ_IN_ROOT) JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Error parsing separator", p);
+				return 0;
+			}
+			c = *p;
+			item_key = &key;
+		}
+
+		if (!closed) {
+			const char *done = NULL;
+			if(c=='[' && ps->depth == 1 && (ps->flags & JSONEZ_PARSE_PARALLEL)) {
+				done = jsonez_parse_parallel(ps, parent, item_key, p);
+				if (!done && ps->error.code) {
+					return 0;
+				}
+			}
+			if(done) {
+				p = done;
+			} else if(c=='{' || c=='[') {
+				if (!jsonez_parse_open(ps, parent, item_key, c, p)) {
+					return 0;
+				}
+				p = jsonez_skip_whitespace(ps, p+1);
+				continue;
+			} else if(ps->sax) {
+				if(c=='t'||c=='f'||c=='"'||JSONEZ_NUMBER(c)) {
+					p = jsonez_sax_value(ps, p);
+				}
+			} else if(c=='t'||c=='f') {
+				p = jsonez_parse_bool_value(ps, parent, item_key, p);
+			} else if(c=='"') {
+				p = jsonez_parse_string_value(ps, parent, item_key, p);
+			} else if(JSONEZ_NUMBER(c)) {
+				p = jsonez_parse_number_value(ps, parent, item_key, p);
+			}
+			if(!p) return 0;
+		} else {
+			ps->depth--;
+			if (!ps->depth) {
+				return p;
+			}
+		}
+
+		// after a value, or a container that just closed, look for the next
+		// item of whatever is open now, closing arrays as they end
+		for (;;) {
+			top = &ps->stack[ps->depth - 1];
+			if (top->kind == JSONEZ_IN_SLICE) {
+				// the next item or the end of the input, a trailing comma included
+				const char *q = jsonez_skip_whitespace(ps, p);
+				if (JSONEZ_AT(ps, q) == ',') {
+					q = jsonez_skip_whitespace(ps, q + 1);
+				}
+				if (JSONEZ_AT(ps, q)) {
+					p = jsonez_next_arr(ps, p);
+					if(!p) return 0;
+					if(*p!=']') {
+						break;
+					}
+					JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Syntax Error", p);
+					return 0;
+				}
+				p = q;
+			} else if (top->kind == JSONEZ_IN_ARRAY) {
+				p = jsonez_next_arr(ps, p);
+				if(!p) return 0;
+				if(*p!=']') {
+					break;
+				}
+				p++;
+			} else {
+				p = jsonez_next_obj(ps, p);
+				if(!p) return 0;
+				if(top->kind != JSONEZ_IN_ROOT || JSONEZ_AT(ps, p)!='\0') {
+					break;
+				}
+			}
+			if (!jsonez_parse_close(ps, top)) {
+				return 0;
+			}
+			if (--ps->depth == 0) {
+				return p;
+			}
+		}
+
+	}
+
+	return p;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Structural index
+//
+// JSONEZ_PARSE_TWO_STAGE. stage 1 classifies the input 64 bytes at a time
+// and records every token: brackets and separators, both quotes of each
+// string and the escapes inside it, and where each number, literal and raw
+// key starts and ends. strings are found with bit tricks on the quote and
+// backslash masks, and comments are cut out of those masks. stage 2 builds
+// the tree from those positions, so strings are copied and scalars
+// converted without looking for where they end, and whitespace and
+// comments are never read at all.
+//
+// stage 2 only takes well formed input. anything else, a NUL or a stray
+// byte included, makes it give up and throw away what it built, and the
+// byte at a time parser does the input again so the tree and the error
+// come out the same either way. the index is built a window at a time just
+// ahead of stage 2, so it stays in cache and its size doesn't depend on
+// the input.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef JSONEZ_STAGE1_WINDOW
+#define JSONEZ_STAGE1_WINDOW (16*1024) // a multiple of 64
+#endif
+
+
+typedef struct jsonez_stage1 {
+
+	const char *base; // the window, positions are offsets from here
+	const char *next; // where the next window starts
+	size_t count;
+	size_t at; // the next token stage 2 hasn't taken
+
+	// what the last block ended in
+	uint64_t in_string; // all ones inside a string
+	uint64_t escaped; // 1 after an unescaped backslash
+	uint64_t scalar; // 1 inside a number, literal or key
+	int comment; // '/' or '*' inside one
+	int skip; // bytes of the next block a comment marker still covers
+	bool broken; // a NUL, or the input ends in a string or comment
+
+	uint32_t pos[JSONEZ_STAGE1_WINDOW]; // a byte is one token at most
+	// last, so setup can skip clearing it
+
+} jsonez_stage1;
+
+
+// every bit from each quote to the next one flips
+static uint64_t jsonez_prefix_xor(uint64_t x) {
+
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+
+}
+
+
+// splits the backslashes into the ones that start an escape, which come
+// back, and the bytes those escape. carry is 1 when the last block ended
+// in a backslash that escapes the first byte of this one.
+static uint64_t jsonez_escapes(uint64_t backslash, uint64_t *carry, uint64_t *escaped) {
+
+	const uint64_t odd_bits = 0xAAAAAAAAAAAAAAAAull;
+	uint64_t first = backslash & ~*carry;
+	// subtracting each run's start from the odd bits flips every other bit of the run
+	uint64_t codes = (((first << 1) | odd_bits) - first) ^ odd_bits;
+	*escaped = codes ^ (backslash | *carry);
+	uint64_t escape = codes & backslash;
+	*carry = escape >> 63;
+	return escape;
+
+}
+
+
+// the tokens in the 64 bytes at block, which are a copy when p is too
+// close to the end to read that far. a scalar's end is the first byte
+// after it, which is only a token of its own after whitespace or a
+// comment. comments are cut out one at a time, the bytes after one go
+// through the masks again as if the block started there.
+static uint64_t jsonez_stage1_block(jsonez_parser *ps, jsonez_stage1 *s, const char *block, const char *p) {
+
+	jsonez_masks m;
+	ps->simd->classify(block, &m);
+	s->broken |= m.nul != 0;
+
+	// what follows each byte, the one after the block included
+	char after = p + 64 < ps->end ? p[64] : '\0';
+	uint64_t opens = (m.slash | m.star) >> 1 | (uint64_t)(after == '/' || after == '*') << 63;
+	uint64_t closes = m.slash >> 1 | (uint64_t)(after == '/') << 63;
+
+	uint64_t tokens = 0;
+	int from = s->skip;
+	s->skip = 0;
+	for (;;) {
+		uint64_t rest = ~0ull << from;
+		if (s->comment) {
+			uint64_t ends = (s->comment == '/' ? m.newline : m.star & closes) & rest;
+			if (!ends) {
+				return tokens;
+			}
+			from = jsonez_ctz(ends) + (s->comment == '/' ? 1 : 2);
+			s->comment = 0;
+			if (from >= 64) {
+				s->skip = from - 64;
+				return tokens;
+			}
+			continue;
+		}
+
+		// most blocks have no backslash, only the carry can escape then
+		uint64_t carry = s->escaped;
+		uint64_t escaped = carry;
+		uint64_t escape = 0;
+		if (m.backslash & rest) {
+			escape = jsonez_escapes(m.backslash & rest, &carry, &escaped);
+		} else {
+			carry = 0;
+		}
+		uint64_t quote = m.quote & ~escaped & rest;
+		uint64_t in_string = (jsonez_prefix_xor(quote) ^ s->in_string) & rest;
+
+		// everything up to the first comment is settled, the '/' included
+		uint64_t starts = m.slash & opens & ~in_string & rest;
+		uint64_t first = starts & (0 - starts);
+		uint64_t below = first ? first - 1 : ~0ull;
+
+		uint64_t scalar = ~(m.op | m.space | quote | in_string) & rest & below;
+		uint64_t before = (scalar << 1) | s->scalar;
+		tokens |= ((m.op & ~in_string) | quote | (escape & in_string) | (scalar ^ before)) & rest & (below | first);
+		if (!first) {
+			s->escaped = carry;
+			s->in_string = (uint64_t)((int64_t)in_string >> 63);
+			s->scalar = scalar >> 63;
+			return tokens;
+		}
+
+		int at = jsonez_ctz(first);
+		s->comment = at < 63 ? (m.slash >> (at + 1) & 1 ? '/' : '*') : after;
+		s->escaped = s->in_string = s->scalar = 0;
+		from = at + 2;
+		if (from >= 64) {
+			s->skip = from - 64;
+			return tokens;
+		}
+	}
+
+}
+
+
+static void jsonez_stage1_window(jsonez_parser *ps) {
+
+	jsonez_stage1 *s = ps->stage1;
+	const char *p = s->next;
+	const char *stop = ps->end - p > JSONEZ_STAGE1_WINDOW ? p + JSONEZ_STAGE1_WINDOW : ps->end;
+	s->base = p;
+	s->count = 0;
+	s->at = 0;
+
+	for (; p < stop; p += 64) {
+		const char *block = p;
+		char tail[64];
+		uint64_t keep = ~0ull;
+		if (stop - p < 64) {
+			// spaces change nothing past the end, but a scalar ends there
+			memset(tail, ' ', sizeof(tail));
+			memcpy(tail, p, stop - p);
+			block = tail;
+			keep = (1ull << (stop - p)) - 1;
+		}
+		uint64_t tokens = jsonez_stage1_block(ps, s, block, p) & keep;
+		uint32_t offset = (uint32_t)(p - s->base);
+		while (tokens) {
+			s->pos[s->count++] = offset + jsonez_ctz(tokens);
+			tokens &= tokens - 1;
+		}
+	}
+	s->next = stop;
+	if (stop == ps->end && (s->in_string || s->comment)) {
+		s->broken = true;
+	}
+
+}
+
+
+// the windows go until one has a token, a broken one gives none at all
+static const char *jsonez_stage1_refill(jsonez_parser *ps) {
+
+	jsonez_stage1 *s = ps->stage1;
+	while (s->at == s->count && !s->broken && s->next < ps->end) {
+		jsonez_stage1_window(ps);
+	}
+	if (s->broken) {
+		s->at = s->count = 0;
+	}
+	return s->at < s->count ? s->base + s->pos[s->at] : NULL;
+
+}
+
+
+// the next token, null at the end of the input and once stage 1 found
+// something only the byte at a time parser handles
+static const char *jsonez_stage1_peek(jsonez_parser *ps) {
+
+	jsonez_stage1 *s = ps->stage1;
+	if (s->at < s->count) {
+		return s->base + s->pos[s->at];
+	}
+	return jsonez_stage1_refill(ps);
+
+}
+
+
+static const char *jsonez_stage1_next(jsonez_parser *ps) {
+
+	const char *p = jsonez_stage1_peek(ps);
+	ps->stage1->at += p != NULL;
+	return p;
+
+}
+
+
+// p is a number, literal or raw key, which ends at the next token. that
+// token is only a marker when whitespace or a comment comes next.
+static const char *jsonez_stage2_scalar(jsonez_parser *ps, const char *p) {
+
+	const char *e = jsonez_stage1_peek(ps);
+	if (!e) {
+		return ps->end;
+	}
+	if (*e == '/' || JSONEZ_WHITESPACE(*e)) {
+		ps->stage1->at++;
+	}
+	return e;
+
+}
+
+
+// p is on an opening quote, the next tokens are its escapes and then the
+// closing quote. the text between them is copied as it is, like
+// jsonez_scan_string a string with escapes is decoded into ps->scratch.
+static bool jsonez_stage2_string(jsonez_parser *ps, const char *p, const char **str, size_t *len) {
+
+	const char *run = p + 1;
+	const char *q = jsonez_stage1_next(ps);
+	if (q && *q == '"') {
+		*str = run;
+		*len = q - run;
+		return true;
+	}
+
+	size_t used = 0;
+	for (;;) {
+		if (!q) {
+			return false;
+		}
+		size_t n = q - run;
+		if (!jsonez_scratch_reserve(ps, used + n + 1)) {
+			return false;
+		}
+		memcpy(ps->scratch + used, run, n);
+		used += n;
+		if (*q == '"') {
+			break;
+		}
+		if (q + 1 >= ps->end || !JSONEZ_ESCAPE(q[1])) {
+			return false;
+		}
+		ps->scratch[used++] = jsonez_unescape(q[1]);
+		run = q + 2;
+		q = jsonez_stage1_next(ps);
+	}
+
+	*str = ps->scratch;
+	*len = used;
+	return true;
+
+}
+
+
+// a key and its separator, returns the value after them
+static const char *jsonez_stage2_key(jsonez_parser *ps, jsonez_key *key, const char *p) {
+
+	const char *s = p;
+	size_t len;
+	if (*p == '"') {
+		if (!jsonez_stage2_string(ps, p, &s, &len)) {
+			return NULL;
+		}
+	} else {
+		const char *e = jsonez_stage2_scalar(ps, p);
+		for (; p < e; p++) {
+			if (!JSONEZ_RAW_KEY(*p)) {
+				return NULL;
+			}
+		}
+		len = e - s;
+	}
+	if (!jsonez_parse_intern(ps, key, s, len)) {
+		return NULL;
+	}
+
+	p = jsonez_stage1_next(ps);
+	if (!p || (*p != ':' && *p != '=')) {
+		return NULL;
+	}
+	return jsonez_stage1_next(ps);
+
+}
+
+
+// a string, number or literal at *at, which moves on to the next token
+static bool jsonez_stage2_value(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char **at) {
+
+	const char *p = *at;
+	char c = *p;
+	if (c != '"' && c != 't' && c != 'f' && !JSONEZ_NUMBER(c)) {
+		return false;
+	}
+	jsonez *json = jsonez_parse_create(ps, parent, key, p);
+	if (!json) {
+		return false;
+	}
+
+	if (c == '"') {
+		const char *s;
+		size_t len;
+		if (!jsonez_stage2_string(ps, p, &s, &len)) {
+			return false;
+		}
+		char *d = ps->arena ? (char *)jsonez_arena_alloc(ps->arena, len+1) : (char *)malloc(len+1);
+		if (!d) {
+			return false;
+		}
+		memcpy(d, s, len);
+		d[len] = '\0';
+		json->s = d;
+		json->type = JSON_STRING;
+	} else {
+		const char *e = jsonez_stage2_scalar(ps, p);
+		if (c == 't' || c == 'f') {
+			json->i = c == 't';
+			if (e - p != (c == 't' ? 4 : 5) || memcmp(p, c == 't' ? "true" : "false", e - p)) {
+				return false;
+			}
+			json->type = JSON_BOOL;
+		} else if (jsonez_scan_number(p, e, json) != e || json->n - json->n != 0) {
+			json->flags &= ~(JSONEZ_NODE_INT | JSONEZ_NODE_UINT);
+			json->index = NULL;
+			return false;
+		} else {
+			json->type = JSON_NUMBER;
+		}
+	}
+
+	*at = jsonez_stage1_next(ps);
+	return true;
+
+}
+
+
+// the same walk as jsonez_parse_values, only with tokens instead of
+// bytes. false as soon as it isn't sure the byte at a time parser would
+// build this exact tree.
+static bool jsonez_stage2(jsonez_parser *ps, jsonez *root) {
+
+	const char *p = jsonez_stage1_next(ps);
+	if (!p) {
+		return false;
+	}
+	ps->depth = 0;
+	if (*p == '{') {
+		jsonez_parse_push(ps, root, JSONEZ_IN_OBJECT);
+		p = jsonez_stage1_next(ps);
+	} else {
+		jsonez_parse_push(ps, root, JSONEZ_IN_ROOT);
+	}
+
+	// p is where an item starts
+	for (;;) {
+
+		jsonez_frame *top = &ps->stack[ps->depth - 1];
+		jsonez_key key = {0};
+		jsonez_key *item_key = NULL;
+		if (top->kind != JSONEZ_IN_ARRAY) {
+			if (!p || (*p != '"' && !JSONEZ_RAW_KEY(*p))) {
+				return false;
+			}
+			p = jsonez_stage2_key(ps, &key, p);
+			if (!p) {
+				return false;
+			}
+			item_key = &key;
+		}
+
+		char c = *p;
+		if (c == '{' || c == '[') {
+			if (!jsonez_parse_open(ps, top->node, item_key, c, p)) {
+				return false;
+			}
+			p = jsonez_stage1_next(ps);
+			// an array can start with one comma
+			if (c == '[' && p && *p == ',') {
+				p = jsonez_stage1_next(ps);
+			}
+			if (!p) {
+				return false;
+			}
+			if (*p != (c == '[' ? ']' : '}')) {
+				continue;
+			}
+		} else if (!jsonez_stage2_value(ps, top->node, item_key, &p)) {
+			return false;
+		}
+
+		// after an item, or on the closer of an empty container, look for
+		// the next item of whatever is open, closing containers as they end
+		for (;;) {
+			top = &ps->stack[ps->depth - 1];
+			bool array = top->kind == JSONEZ_IN_ARRAY;
+			char closer = array ? ']' : '}';
+			if (p && *p == ',') {
+				p = jsonez_stage1_next(ps);
+				if (p && *p != '}' && *p != ']') {
+					break;
+				}
+			} else if (array && p && *p != ']') {
+				break;
+			}
+			if (top->kind == JSONEZ_IN_ROOT ? p != NULL : !p || *p != closer) {
+				return false;
+			}
+			if (!jsonez_parse_close(ps, top)) {
+				return false;
+			}
+			if (p) {
+				p = jsonez_stage1_next(ps);
+			}
+			if (--ps->depth == 0) {
+				return !p && !ps->stage1->broken;
+			}
+		}
+
+	}
+
+}
+
+
+// drops whatever stage 2 built before it gave up, mark is where the arena
+// was before it started
+static void jsonez_stage2_undo(jsonez_parser *ps, jsonez *root, jsonez_arena_block *mark, size_t used, jsonez_keypool *keys) {
+
+	if (ps->arena) {
+		while (ps->arena->head != mark) {
+			jsonez_arena_block *next = ps->arena->head->next;
+			free(ps->arena->head);
+			ps->arena->head = next;
+		}
+		if (mark) {
+			mark->used = used;
+		}
+		// a pool made along the way was in the arena too
+		if (!keys) {
+			ps->keys = ps->doc->keys = NULL;
+		}
+	} else {
+		jsonez_index_drop(root);
+		jsonez_free(root->child);
+	}
+	root->child = NULL;
+	root->index = NULL;
+	root->i = 0;
+	memset(&ps->error, 0, sizeof(ps->error));
+
+}
+
+
+// false when the byte at a time parser has to do the input after all,
+// with the root as empty as it started
+static bool jsonez_parse_two_stage(jsonez_parser *ps, jsonez *root) {
+
+	// in situ parsing rewrites the input a second try would need
+	if (!(ps->flags & JSONEZ_PARSE_TWO_STAGE) || (ps->flags & (JSONEZ_PARSE_INSITU | JSONEZ_PARSE_PARALLEL))) {
+		return false;
+	}
+	jsonez_stage1 *s = (jsonez_stage1 *)malloc(sizeof(jsonez_stage1));
+	if (!s) {
+		return false;
+	}
+	memset(s, 0, offsetof(jsonez_stage1, pos));
+	s->next = ps->begin;
+	ps->stage1 = s;
+
+	jsonez_arena_block *mark = ps->arena ? ps->arena->head : NULL;
+	size_t used = mark ? mark->used : 0;
+	jsonez_keypool *keys = ps->keys;
+	bool ok = jsonez_stage2(ps, root);
+	if (!ok) {
+		jsonez_stage2_undo(ps, root, mark, used, keys);
+	}
+	ps->stage1 = NULL;
+	free(s);
+	return ok;
+
+}
+
+
+// an empty file maps to null, false when it can't be opened
+static bool jsonez_map(const char *path, bool writable, void **map, size_t *size) {
+
+	*map = NULL;
+	*size = 0;
+
+#ifdef _WIN32
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	*size = (size_t)ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (*size) {
+		*map = malloc(*size);
+		if (!*map) {
+			fclose(file);
+			return false;
+		}
+		*size = fread(*map, 1, *size, file);
+	}
+	fclose(file);
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		// a private writable mapping lets the in situ parser terminate
+		// strings without touching the file, only those pages get copied
+		int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+		void *mem = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+		if (mem == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+#ifdef POSIX_MADV_SEQUENTIAL
+		// only a hint, and strict C builds don't declare it
+		posix_madvise(mem, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+		*map = mem;
+		*size = (size_t)st.st_size;
+	}
+	close(fd);
+#endif
+
+	return true;
+
+}
+
+
+static void jsonez_unmap(void *map, size_t size) {
+
+	if (map) {
+#ifdef _WIN32
+		free(map);
+#else
+		munmap(map, size);
+#endif
+	}
+
+}
+
+
+JSONEZDEF void jsonez_free(jsonez *json) {
+
+	// children get spliced in right after their parent, so the whole tree
+	// turns into one list that is freed front to back without recursing.
+	// the first child's prev is the last child, which makes that O(1).
+	while (json) {
+
+		if (json->child) {
+			jsonez *last = json->child->prev;
+			last->next = json->next;
+			json->next = json->child;
+			json->child = NULL;
+		}
+		jsonez *next = json->next;
+
+		// arena memory goes back with the arena, but heap nodes can still
+		// hang below an arena node so keep walking
+		bool owned = !(json->flags & JSONEZ_NODE_ARENA);
+		if (owned) {
+			if (!(json->flags & JSONEZ_NODE_KEY_BORROWED)) {
+				free(json->key);
+			}
+			if (json->type == JSON_STRING && !(json->flags & JSONEZ_NODE_STR_BORROWED)) {
+				free(json->s);
+			}
+		}
+		jsonez_index_drop(json);
+
+		if (owned) {
+			if (json->flags & JSONEZ_NODE_DOC) {
+				jsonez_document *doc = (jsonez_document *)json;
+				jsonez_keypool_destroy(doc->keys);
+				jsonez_unmap(doc->map, doc->map_size);
+			}
+			free (json);
+		}
+		json = next;
+	}
+
+}
+
+
+// null when memory runs out, which goes in the error
+static jsonez *jsonez_parse_root(jsonez_parser *ps) {
+
+	ps->doc = (jsonez_document *)jsonez_alloc(ps->arena, sizeof(jsonez_document));
+	if (!ps->doc) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", NULL);
+		if (ps->report) {
+			*ps->report = ps->error;
+		}
+		return NULL;
+	}
+	jsonez *json = &ps->doc->root;
+	json->flags |= JSONEZ_NODE_DOC;
+	if (ps->arena) {
+		json->flags |= JSONEZ_NODE_ARENA;
+	}
+	return json;
+
+}
+
+
+// the root is an object whatever happened, what got parsed stays in it
+static jsonez *jsonez_parse_done(jsonez_parser *ps) {
+
+	jsonez *json = &ps->doc->root;
+	json->type = JSON_OBJ;
+	if (!json->index) {
+		jsonez_parse_index(ps, json);
+	}
+	if (ps->report) {
+		*ps->report = ps->error;
+	}
+	free(ps->scratch);
+	if (ps->stack != ps->frames) {
+		free(ps->stack);
+	}
+	return json;
+
+}
+
+
+// p is just past the root, or null when it didn't parse. only whitespace
+// and comments may follow it, a comment left open is only caught here. a
+// NUL ends the input as it does anywhere else.
+static bool jsonez_parse_rest(jsonez_parser *ps, const char *p) {
+
+	p = jsonez_skip_whitespace(ps, p);
+	if (p && JSONEZ_AT(ps, p)) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Text after the root", p);
+		return false;
+	}
+	return p != NULL;
+
+}
+
+
+static jsonez *jsonez_parse_document(jsonez_parser *ps, const char *file, size_t len) {
+
+	jsonez *json = jsonez_parse_root(ps);
+	if (!json) {
+		return NULL;
+	}
+
+	const char *p = file;
+	if (p == 0 || len == 0) {
+		return jsonez_parse_done(ps);
+	}
+	ps->begin = p;
+	ps->end = p + len;
+	if (jsonez_parse_two_stage(ps, json)) {
+		return jsonez_parse_done(ps);
+	}
+
+	p = jsonez_skip_whitespace(ps, p);
+
+
+	if(JSONEZ_AT(ps, p)=='{') {
+		p = jsonez_parse_values(ps, json, JSONEZ_IN_OBJECT, p+1);
+	} else {
+		p = jsonez_parse_values(ps, json, JSONEZ_IN_ROOT, p);
+	}
+
+	if (!jsonez_parse_rest(ps, p)) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_EOF, "Unexpected end of file", p);
+	}
+
+	return jsonez_parse_done(ps);
+
+}
+
+
+static void jsonez_parser_init(jsonez_parser *ps, jsonez_parse_opts *opts) {
+
+	memset(ps, 0, sizeof(jsonez_parser));
+	ps->simd = jsonez_pick_kernels();
+	ps->stack = ps->frames;
+	ps->stack_size = JSONEZ_FRAMES_INLINE;
+	if (opts) {
+		ps->arena = opts->arena;
+		ps->flags = opts->flags;
+		ps->keys = opts->keys;
+		ps->threads = opts->threads;
+		ps->report = opts->error;
+	}
+
+}
+
+
+JSONEZDEF jsonez *jsonez_parse(char *file) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, NULL);
+	return jsonez_parse_document(&ps, file, file ? strlen(file) : 0);
+
+}
+
+
+JSONEZDEF jsonez *jsonez_parse_ex(char *file, jsonez_parse_opts *opts) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, opts);
+	return jsonez_parse_document(&ps, file, file ? strlen(file) : 0);
+
+}
+
+
+JSONEZDEF jsonez *jsonez_parse_n(const char *data, size_t len, jsonez_parse_opts *opts) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, opts);
+	// the input may be read only, so everything gets copied out of it
+	ps.flags &= ~JSONEZ_PARSE_INSITU;
+	return jsonez_parse_document(&ps, data, len);
+
+}
+
+
+// the walk behind jsonez_parse_sax and jsonez_validate, the root is
+// reported as an object whether it has braces or not
+static bool jsonez_parse_events(jsonez_parser *ps, const char *data, size_t len) {
+
+	jsonez_handler *handler = ps->sax;
+	bool ok = jsonez_sax_go(ps, !handler->begin_object || handler->begin_object(handler->user));
+	if (ok && data && len) {
+		ps->begin = data;
+		ps->end = data + len;
+		const char *p = jsonez_skip_whitespace(ps, data);
+		if (JSONEZ_AT(ps, p) == '{') {
+			p = jsonez_parse_values(ps, NULL, JSONEZ_IN_OBJECT, p + 1);
+		} else {
+			p = jsonez_parse_values(ps, NULL, JSONEZ_IN_ROOT, p);
+		}
+		ok = jsonez_parse_rest(ps, p);
+	} else if (ok) {
+		ok = jsonez_sax_go(ps, !handler->end_object || handler->end_object(handler->user));
+	}
+
+	free(ps->scratch);
+	if (ps->stack != ps->frames) {
+		free(ps->stack);
+	}
+	return ok;
+
+}
+
+
+JSONEZDEF bool jsonez_parse_sax(const char *data, size_t len, jsonez_handler *handler, jsonez_error *error) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, NULL);
+	ps.sax = handler;
+	bool ok = jsonez_parse_events(&ps, data, len);
+	if (!ok && !ps.stopped) {
+		// the same as the tree parser, which ends up here too
+		JSONEZ_ERROR(&ps, JSONEZ_ERROR_EOF, "Unexpected end of file", NULL);
+	}
+	if (error) {
+		*error = ps.error;
+	}
+	// bad comments are recorded without stopping the walk
+	return ps.error.code == JSONEZ_OK && !ps.stopped;
+
+}
+
+
+JSONEZDEF bool jsonez_validate(const char *data, size_t len, jsonez_error *error) {
+
+	jsonez_handler none;
+	memset(&none, 0, sizeof(none));
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, NULL);
+	ps.sax = &none;
+	ps.validate = true;
+
+	if (!jsonez_parse_events(&ps, data, len)) {
+		// the same as the tree parser, which ends up here too
+		JSONEZ_ERROR(&ps, JSONEZ_ERROR_EOF, "Unexpected end of file", NULL);
+	}
+	// bad comments are recorded without stopping the walk
+	if (error) {
+		*error = ps.error;
+	}
+	return ps.error.code == JSONEZ_OK;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_parse_file(const char *path, jsonez_parse_opts *opts) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, opts);
+	ps.flags &= ~JSONEZ_PARSE_INSITU;
+
+	// a reset can't unmap the file, so arena trees copy their strings
+	bool keep = (ps.flags & JSONEZ_PARSE_KEEP_MAP) && !ps.arena;
+	void *map;
+	size_t size;
+	if (!jsonez_map(path, keep, &map, &size)) {
+		return NULL;
+	}
+
+	if (keep) {
+		ps.flags |= JSONEZ_PARSE_INSITU;
+	}
+	jsonez *json = jsonez_parse_document(&ps, (const char *)map, size);
+
+	if (keep && json) {
+		ps.doc->map = map;
+		ps.doc->map_size = size;
+	} else {
+		jsonez_unmap(map, size);
+	}
+	return json;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_parse_arena(jsonez_arena *arena, char *file) {
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, NULL);
+	ps.arena = arena;
+	return jsonez_parse_document(&ps, file, file ? strlen(file) : 0);
+
+}
+
+
+JSONEZDEF void jsonez_error_position(const char *data, const jsonez_error *error, size_t *line, size_t *column) {
+
+	size_t lines = 1;
+	const char *start = data;
+	const char *end = data + error->offset;
+	for (const char *p = data; (p = (const char *)memchr(p, '\n', end - p)) != NULL; p++) {
+		lines++;
+		start = p + 1;
+	}
+	*line = lines;
+	*column = (size_t)(end - start) + 1;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Worker threads
+//
+// a pool runs one task on all of its workers at once and returns when they
+// are all done. the workers wait between tasks rather than being started for
+// each. the first worker runs on the calling thread, and so does any worker
+// whose thread couldn't be started.
+
+
+typedef void (*jsonez_task)(void *ctx, int worker);
+
+
+// a flag that tasks running at the same time set and read. it is only ever
+// set, so it needs no lock, just loads and stores the compiler can't tear
+// or keep in a register.
+static bool jsonez_flag_get(long *flag) {
+
+#if defined(_MSC_VER)
+	return _InterlockedOr(flag, 0) != 0;
+#else
+	return __atomic_load_n(flag, __ATOMIC_ACQUIRE) != 0;
+#endif
+
+}
+
+
+static void jsonez_flag_set(long *flag) {
+
+#if defined(_MSC_VER)
+	_InterlockedExchange(flag, 1);
+#else
+	__atomic_store_n(flag, 1, __ATOMIC_RELEASE);
+#endif
+
+}
+
+
+struct jsonez_pool;
+
+
+typedef struct jsonez_pool_thread {
+
+	struct jsonez_pool *pool;
+	int worker;
+#ifndef JSONEZ_NO_THREADS
+#ifdef _WIN32
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+	bool started;
+	unsigned int round;
+#endif
+
+} jsonez_pool_thread;
+
+
+typedef struct jsonez_pool {
+
+	int count; // workers, the calling thread included
+	jsonez_pool_thread *at;
+	jsonez_task task;
+	void *ctx;
+
+#ifndef JSONEZ_NO_THREADS
+#ifdef _WIN32
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE wake;
+	CONDITION_VARIABLE done;
+#else
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+#endif
+	unsigned int round; // bumped for every task handed out
+	int busy; // threads still on the current task
+	int threads; // threads that got started
+	bool quit;
+#endif
+
+} jsonez_pool;
+
+
+#ifndef JSONEZ_NO_THREADS
+#ifdef _WIN32
+#define JSONEZ_LOCK(pool) EnterCriticalSection(&(pool)->lock)
+#define JSONEZ_UNLOCK(pool) LeaveCriticalSection(&(pool)->lock)
+#define JSONEZ_WAIT(pool, cond) SleepConditionVariableCS(&(pool)->cond, &(pool)->lock, INFINITE)
+#define JSONEZ_WAKE(pool, cond) WakeAllConditionVariable(&(pool)->cond)
+#else
+#define JSONEZ_LOCK(pool) pthread_mutex_lock(&(pool)->lock)
+#define JSONEZ_UNLOCK(pool) pthread_mutex_unlock(&(pool)->lock)
+#define JSONEZ_WAIT(pool, cond) pthread_cond_wait(&(pool)->cond, &(pool)->lock)
+#define JSONEZ_WAKE(pool, cond) pthread_cond_broadcast(&(pool)->cond)
+#endif
+
+
+#ifdef _WIN32
+static unsigned __stdcall jsonez_pool_thread_main(void *arg) {
+#else
+static void *jsonez_pool_thread_main(void *arg) {
+#endif
+
+	jsonez_pool_thread *t = (jsonez_pool_thread *)arg;
+	jsonez_pool *pool = t->pool;
+	JSONEZ_LOCK(pool);
+	for (;;) {
+		while (t->round == pool->round && !pool->quit) {
+			JSONEZ_WAIT(pool, wake);
+		}
+		if (pool->quit) {
+			break;
+		}
+		t->round = pool->round;
+		JSONEZ_UNLOCK(pool);
+		pool->task(pool->ctx, t->worker);
+		JSONEZ_LOCK(pool);
+		if (--pool->busy == 0) {
+			JSONEZ_WAKE(pool, done);
+		}
+	}
+	JSONEZ_UNLOCK(pool);
+	return 0;
+
+}
+#endif
+
+
+// the number of workers to use when asked for count, zero meaning one per core
+static int jsonez_pool_size(int count) {
+
+	if (count > 0) {
+		return count;
+	}
+#if defined(JSONEZ_NO_THREADS)
+	return 1;
+#elif defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors ? (int)info.dwNumberOfProcessors : 1;
+#else
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return cores > 0 ? (int)cores : 1;
+#endif
+
+}
+
+
+static bool jsonez_pool_start(jsonez_pool *pool, int count) {
+
+	memset(pool, 0, sizeof(jsonez_pool));
+	pool->at = (jsonez_pool_thread *)calloc(count, sizeof(jsonez_pool_thread));
+	if (!pool->at) {
+		return false;
+	}
+	pool->count = count;
+	for (int i = 0; i < count; i++) {
+		pool->at[i].pool = pool;
+		pool->at[i].worker = i;
+	}
+
+#ifndef JSONEZ_NO_THREADS
+#ifdef _WIN32
+	InitializeCriticalSection(&pool->lock);
+	InitializeConditionVariable(&pool->wake);
+	InitializeConditionVariable(&pool->done);
+#else
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->wake, NULL);
+	pthread_cond_init(&pool->done, NULL);
+#endif
+
+	for (int i = 1; i < count; i++) {
+		jsonez_pool_thread *t = &pool->at[i];
+#ifdef _WIN32
+		t->thread = (HANDLE)_beginthreadex(NULL, 0, jsonez_pool_thread_main, t, 0, NULL);
+		t->started = t->thread != 0;
+#else
+		t->started = pthread_create(&t->thread, NULL, jsonez_pool_thread_main, t) == 0;
+#endif
+		pool->threads += t->started;
+	}
+#endif
+	return true;
+
+}
+
+
+static void jsonez_pool_stop(jsonez_pool *pool) {
+
+#ifndef JSONEZ_NO_THREADS
+	JSONEZ_LOCK(pool);
+	pool->quit = true;
+	JSONEZ_WAKE(pool, wake);
+	JSONEZ_UNLOCK(pool);
+
+	for (int i = 1; i < pool->count; i++) {
+		if (pool->at[i].started) {
+#ifdef _WIN32
+			WaitForSingleObject(pool->at[i].thread, INFINITE);
+			CloseHandle(pool->at[i].thread);
+#else
+			pthread_join(pool->at[i].thread, NULL);
+#endif
+		}
+	}
+
+#ifdef _WIN32
+	DeleteCriticalSection(&pool->lock);
+#else
+	pthread_cond_destroy(&pool->done);
+	pthread_cond_destroy(&pool->wake);
+	pthread_mutex_destroy(&pool->lock);
+#endif
+#endif
+	free(pool->at);
+	pool->at = NULL;
+
+}
+
+
+static void jsonez_pool_each(jsonez_pool *pool, jsonez_task task, void *ctx) {
+
+#ifndef JSONEZ_NO_THREADS
+	JSONEZ_LOCK(pool);
+	pool->task = task;
+	pool->ctx = ctx;
+	pool->busy = pool->threads;
+	pool->round++;
+	JSONEZ_WAKE(pool, wake);
+	JSONEZ_UNLOCK(pool);
+#endif
+
+	for (int i = 0; i < pool->count; i++) {
+#ifndef JSONEZ_NO_THREADS
+		if (pool->at[i].started) {
+			continue;
+		}
+#endif
+		task(ctx, i);
+	}
+
+#ifndef JSONEZ_NO_THREADS
+	JSONEZ_LOCK(pool);
+	while (pool->busy) {
+		JSONEZ_WAIT(pool, done);
+	}
+	JSONEZ_UNLOCK(pool);
+#endif
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Parallel arrays
+//
+// with JSONEZ_PARSE_PARALLEL a big array at the top level gets parsed by
+// several threads. the rest of the input is cut into chunks and each chunk
+// guesses from its first quote where it starts being outside of strings.
+// the chunks are all scanned for brackets at once, then checked in order
+// against the state the chunk before them ended in and scanned again when
+// they guessed wrong. that tells where the array ends and gives a place
+// between two of its items in most chunks. the slices between those places
+// are parsed at once and their items linked into the array in order.
+
+
+#ifndef JSONEZ_PARALLEL_MIN
+#define JSONEZ_PARALLEL_MIN (1024*1024) // arrays shorter than this stay on the calling thread
+#endif
+
+#ifndef JSONEZ_PARALLEL_CHUNK
+#define JSONEZ_PARALLEL_CHUNK (64*1024) // the smallest chunk worth a task
+#endif
+
+
+typedef enum jsonez_scan_state {
+	JSONEZ_SCAN_VALUE, // outside of strings and comments
+	JSONEZ_SCAN_STRING,
+	JSONEZ_SCAN_ESCAPE, // just past a backslash in a string
+	JSONEZ_SCAN_SLASH, // just past a slash that could start a comment
+	JSONEZ_SCAN_LINE,
+	JSONEZ_SCAN_BLOCK,
+	JSONEZ_SCAN_STAR, // just past a star in a block comment
+} jsonez_scan_state;
+
+
+// what scanning a chunk found, depths are relative to where it started
+typedef struct jsonez_span {
+
+	const char *start;
+	const char *stop;
+	jsonez_scan_state state; // at stop
+	long depth;
+	long min;
+	const char *split; // just past the first bracket that closed to min
+	const char **ends; // ends[k] is just past the first bracket that closed to -(k + 1)
+	size_t ends_count;
+	size_t ends_size;
+	bool failed;
+
+} jsonez_span;
+
+
+typedef struct jsonez_slice {
+
+	const char *start;
+	const char *end;
+	jsonez holder; // the items until they go into the array
+	jsonez_keypool *keys;
+	jsonez_error error;
+
+} jsonez_slice;
+
+
+typedef struct jsonez_parallel {
+
+	const jsonez_kernels *simd;
+	int flags;
+	const char *begin; // error offsets count from here
+	size_t base;
+	int count; // workers
+	jsonez_span *spans;
+	size_t span_count;
+	jsonez_slice *slices;
+	size_t slice_count;
+
+} jsonez_parallel;
+
+
+static void jsonez_span_close(jsonez_span *span, const char *p) {
+
+	span->depth--;
+	if (span->depth < span->min) {
+		span->min = span->depth;
+		span->split = p;
+		if (span->ends_count == span->ends_size) {
+			size_t size = span->ends_size ? span->ends_size * 2 : 8;
+			const char **ends = (const char **)realloc((void *)span->ends, size * sizeof(const char *));
+			if (!ends) {
+				span->failed = true;
+				return;
+			}
+			span->ends = ends;
+			span->ends_size = size;
+		}
+		span->ends[span->ends_count++] = p;
+	} else if (span->depth == span->min && !span->split) {
+		span->split = p;
+	}
+
+}
+
+
+// the same automaton as the ndjson splitter, but one that can stop and
+// start again anywhere
+static void jsonez_span_scan(const jsonez_kernels *simd, jsonez_span *span, jsonez_scan_state state) {
+
+	const char *p = span->start;
+	const char *stop = span->stop;
+	span->depth = 0;
+	span->min = 0;
+	span->split = NULL;
+	span->ends_count = 0;
+
+	while (p < stop && !span->failed) {
+		switch (state) {
+		case JSONEZ_SCAN_VALUE:
+			p = simd->find_structural(p, stop);
+			if (p >= stop) {
+				break;
+			}
+			switch (*p++) {
+			case '"': state = JSONEZ_SCAN_STRING; break;
+			case '/': state = JSONEZ_SCAN_SLASH; break;
+			case '{': case '[': span->depth++; break;
+			case '}': case ']': jsonez_span_close(span, p); break;
+			}
+			break;
+		case JSONEZ_SCAN_STRING:
+			p = simd->find_quote(p, stop);
+			if (p >= stop) {
+				break;
+			}
+			if (*p == '"') {
+				state = JSONEZ_SCAN_VALUE;
+			} else if (*p == '\\') {
+				state = JSONEZ_SCAN_ESCAPE;
+			}
+			p++;
+			break;
+		case JSONEZ_SCAN_ESCAPE:
+			state = JSONEZ_SCAN_STRING;
+			p++;
+			break;
+		case JSONEZ_SCAN_SLASH:
+			if (*p == '/' || *p == '*') {
+				state = *p == '/' ? JSONEZ_SCAN_LINE : JSONEZ_SCAN_BLOCK;
+				p++;
+			} else {
+				state = JSONEZ_SCAN_VALUE;
+			}
+			break;
+		case JSONEZ_SCAN_LINE:
+			p = (const char *)memchr(p, '\n', stop - p);
+			if (!p) {
+				p = stop;
+				break;
+			}
+			state = JSONEZ_SCAN_VALUE;
+			p++;
+			break;
+		case JSONEZ_SCAN_BLOCK:
+			p = simd->find_char(p, stop, '*');
+			if (p < stop) {
+				if (*p == '*') {
+					state = JSONEZ_SCAN_STAR;
+				}
+				p++;
+			}
+			break;
+		case JSONEZ_SCAN_STAR:
+			if (*p == '/') {
+				state = JSONEZ_SCAN_VALUE;
+				p++;
+			} else {
+				state = JSONEZ_SCAN_BLOCK;
+			}
+			break;
+		}
+	}
+	span->state = state;
+
+}
+
+
+// a place at or after p that is probably outside of strings: on the first
+// quote when it looks like it opens a string, just past it when what
+// follows looks like the end of a key or a value
+static const char *jsonez_span_guess(const jsonez_kernels *simd, const char *p, const char *begin, const char *end) {
+
+	for (;;) {
+		p = simd->find_char(p, end, '"');
+		if (p >= end) {
+			return end;
+		}
+		if (*p != '"') {
+			p++;
+			continue;
+		}
+		// escaped quotes are inside a string whatever comes next
+		const char *b = p;
+		while (b > begin && b[-1] == '\\') {
+			b--;
+		}
+		if ((p - b) & 1) {
+			p++;
+			continue;
+		}
+		const char *q = simd->skip_space(p + 1, end);
+		char c = q < end ? *q : '\0';
+		if (c == ':' || c == '=' || c == ',' || c == '}' || c == ']') {
+			return p + 1;
+		}
+		return p;
+	}
+
+}
+
+
+static void jsonez_parallel_scan_task(void *ctx, int worker) {
+
+	jsonez_parallel *par = (jsonez_parallel *)ctx;
+	for (size_t i = worker; i < par->span_count; i += par->count) {
+		jsonez_span_scan(par->simd, &par->spans[i], JSONEZ_SCAN_VALUE);
+	}
+
+}
+
+
+static void jsonez_parallel_parse_task(void *ctx, int worker) {
+
+	jsonez_parallel *par = (jsonez_parallel *)ctx;
+	for (size_t i = worker; i < par->slice_count; i += par->count) {
+		jsonez_slice *slice = &par->slices[i];
+		jsonez_parser ps;
+		jsonez_parser_init(&ps, NULL);
+		ps.flags = par->flags;
+		ps.end = slice->end;
+		ps.begin = par->begin;
+		ps.base = par->base;
+
+		// slices after the first start with the comma before their item,
+		// which the walk takes like the one an array may start with. a
+		// second one is an error there as it is anywhere else.
+		const char *p = jsonez_skip_whitespace(&ps, slice->start);
+		if (JSONEZ_AT(&ps, p)) {
+			ps.keys = slice->keys = jsonez_keypool_new(NULL, (ps.end - p) + 64);
+			if (!ps.keys) {
+				JSONEZ_ERROR(&ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+			} else if (!jsonez_parse_values(&ps, &slice->holder, JSONEZ_IN_SLICE, p)) {
+				jsonez_fail(&ps, JSONEZ_ERROR_SYNTAX, "Syntax Error", NULL);
+			}
+		}
+
+		slice->error = ps.error;
+		free(ps.scratch);
+		if (ps.stack != ps.frames) {
+			free(ps.stack);
+		}
+	}
+
+}
+
+
+// a slice's keys join the document's pool without going into its table,
+// interning only saves memory so that table needn't know about them
+static void jsonez_parallel_keys(jsonez_parser *ps, jsonez_keypool *keys) {
+
+	if (!keys) {
+		return;
+	}
+	if (!ps->keys) {
+		ps->keys = ps->doc->keys = keys;
+		return;
+	}
+
+	jsonez_arena *into = ps->keys->arena;
+	jsonez_arena *from = keys->arena;
+	if (from->head) {
+		jsonez_arena_block *last = from->head;
+		while (last->next) {
+			last = last->next;
+		}
+		// behind the block the pool is filling, which keeps filling
+		if (into->head) {
+			last->next = into->head->next;
+			into->head->next = from->head;
+		} else {
+			into->head = from->head;
+		}
+	}
+	free(from);
+	free(keys->slots);
+	free(keys);
+
+}
+
+
+// appends the holder's items to array, which takes O(1) as the first
+// item's prev is the last one
+static void jsonez_parallel_splice(jsonez *array, jsonez *holder) {
+
+	jsonez *first = holder->child;
+	if (!first) {
+		return;
+	}
+	if (array->child) {
+		jsonez *last = array->child->prev;
+		last->next = first;
+		array->child->prev = first->prev;
+		first->prev = last;
+	} else {
+		array->child = first;
+	}
+	array->i += holder->i;
+	holder->child = NULL;
+	holder->i = 0;
+
+}
+
+
+static void jsonez_parallel_free(jsonez_parallel *par) {
+
+	for (size_t i = 0; i < par->span_count; i++) {
+		free((void *)par->spans[i].ends);
+	}
+	free(par->spans);
+	free(par->slices);
+
+}
+
+
+// p is on the '[' of an array at the top level of the document. returns
+// just past its end once it's parsed and linked into parent. null leaves
+// the array to the caller, unless ps->error got set because a slice of it
+// didn't parse, in which case what did parse is in the tree.
+static const char *jsonez_parse_parallel(jsonez_parser *ps, jsonez *parent, jsonez_key *key, const char *p) {
+
+	if (ps->sax || ps->arena || ps->end - p < JSONEZ_PARALLEL_MIN) {
+		return NULL;
+	}
+	int count = jsonez_pool_size(ps->threads);
+	if (count < 2) {
+		return NULL;
+	}
+
+	// an array that ends within the first JSONEZ_PARALLEL_MIN bytes goes
+	// the usual way, finding that out costs less than parsing it
+	const char *begin = p + 1;
+	jsonez_span head;
+	memset(&head, 0, sizeof(head));
+	head.start = begin;
+	head.stop = p + JSONEZ_PARALLEL_MIN;
+	jsonez_span_scan(ps->simd, &head, JSONEZ_SCAN_VALUE);
+	free((void *)head.ends);
+	if (head.failed || head.min < 0) {
+		return NULL;
+	}
+
+	jsonez_parallel par;
+	memset(&par, 0, sizeof(par));
+	par.simd = ps->simd;
+	par.flags = ps->flags & ~JSONEZ_PARSE_PARALLEL;
+	par.begin = ps->begin;
+	par.base = ps->base;
+	par.count = count;
+
+	size_t len = ps->end - begin;
+	size_t n = (size_t)count * 4;
+	if (len / n < JSONEZ_PARALLEL_CHUNK) {
+		n = len / JSONEZ_PARALLEL_CHUNK ? len / JSONEZ_PARALLEL_CHUNK : 1;
+	}
+	par.spans = (jsonez_span *)calloc(n, sizeof(jsonez_span));
+	par.slices = (jsonez_slice *)calloc(n + 1, sizeof(jsonez_slice));
+	jsonez_pool pool;
+	if (!par.spans || !par.slices || !jsonez_pool_start(&pool, count)) {
+		jsonez_parallel_free(&par);
+		return NULL;
+	}
+	par.span_count = n;
+	for (size_t i = 0; i < n; i++) {
+		par.spans[i].start = i ? jsonez_span_guess(ps->simd, begin + len / n * i, begin, ps->end) : begin;
+	}
+	for (size_t i = 0; i < n; i++) {
+		par.spans[i].stop = i + 1 < n ? par.spans[i + 1].start : ps->end;
+	}
+	jsonez_pool_each(&pool, jsonez_parallel_scan_task, &par);
+
+	// a chunk only knows its depths once the ones before it are known, and
+	// one whose guess doesn't match how the chunk before ended is wrong
+	long depth = 1;
+	jsonez_scan_state state = JSONEZ_SCAN_VALUE;
+	const char *from = begin;
+	const char *close = NULL;
+	for (size_t i = 0; i < n; i++) {
+		jsonez_span *span = &par.spans[i];
+		if (state != JSONEZ_SCAN_VALUE) {
+			jsonez_span_scan(ps->simd, span, state);
+		}
+		if (span->failed) {
+			break;
+		}
+		if (depth + span->min <= 0) {
+			close = span->ends[depth - 1] - 1;
+			break;
+		}
+		if (depth + span->min == 1 && span->split) {
+			par.slices[par.slice_count].start = from;
+			par.slices[par.slice_count++].end = span->split;
+			from = span->split;
+		}
+		depth += span->depth;
+		state = span->state;
+	}
+
+	// unterminated or mismatched, which the usual way reports better
+	if (!close || *close != ']') {
+		jsonez_pool_stop(&pool);
+		jsonez_parallel_free(&par);
+		return NULL;
+	}
+	par.slices[par.slice_count].start = from;
+	par.slices[par.slice_count++].end = close;
+
+	jsonez *array = jsonez_parse_create(ps, parent, key, p);
+	if (!array) {
+		jsonez_pool_stop(&pool);
+		jsonez_parallel_free(&par);
+		return NULL;
+	}
+	jsonez_pool_each(&pool, jsonez_parallel_parse_task, &par);
+	jsonez_pool_stop(&pool);
+
+	array->type = JSON_ARRAY;
+	for (size_t i = 0; i < par.slice_count; i++) {
+		jsonez_slice *slice = &par.slices[i];
+		jsonez_parallel_splice(array, &slice->holder);
+		jsonez_index_drop(&slice->holder);
+		jsonez_parallel_keys(ps, slice->keys);
+		if (slice->error.code && !ps->error.code) {
+			ps->error = slice->error;
+		}
+	}
+	jsonez_parse_index(ps, array);
+
+	jsonez_parallel_free(&par);
+	return ps->error.code ? NULL : close + 1;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Newline delimited records
+//
+// each batch of input is cut into a chunk per worker. a worker splits the
+// records starting in its chunk, beginning after the chunk's first newline
+// and finishing the last record past the chunk's end. that first newline
+// could be inside a string or comment, so once all chunks are split the
+// start of each one is checked against where the one before it ended and
+// split again on its own when they differ. then the workers parse the
+// records they found. ordered delivery waits for the whole batch.
+
+
+#ifndef JSONEZ_NDJSON_CHUNK
+#define JSONEZ_NDJSON_CHUNK (256*1024) // bytes per worker and batch
+#endif
+
+
+typedef struct jsonez_ndjson_item {
+
+	const char *start;
+	const char *end;
+	jsonez *json;
+	jsonez_error error;
+
+} jsonez_ndjson_item;
+
+
+typedef struct jsonez_ndjson_run {
+
+	const char *data;
+	const char *end;
+	const jsonez_kernels *simd;
+	int flags;
+	bool unordered;
+	jsonez_record_fn fn;
+	void *user;
+	long stop; // see jsonez_flag_get, unordered workers set and read it at once
+
+} jsonez_ndjson_run;
+
+
+typedef struct jsonez_ndjson_worker {
+
+	jsonez_ndjson_run *run;
+	const char *from; // the chunk
+	const char *to;
+	const char *start; // where splitting began
+	const char *next; // where the record after the last one starts
+	jsonez_ndjson_item *items;
+	size_t count;
+	size_t size;
+	size_t first; // index of the first record in the whole input
+	bool failed;
+
+} jsonez_ndjson_worker;
+
+
+// the end of the record starting at p, which is the first newline outside
+// strings and block comments or the end of the input
+static const char *jsonez_ndjson_end(const jsonez_kernels *simd, const char *p, const char *end) {
+
+	const char *nl = (const char *)memchr(p, '\n', end - p);
+	if (!nl) {
+		nl = end;
+	}
+	for (;;) {
+		p = simd->find_structural(p, nl);
+		if (p >= nl) {
+			return nl;
+		}
+		if (*p == '"') {
+			// the kernels stop at backslashes and terminators too
+			p = simd->find_quote(p + 1, end);
+			while (p < end && *p != '"') {
+				p = simd->find_quote(p + (*p == '\\' ? 2 : 1), end);
+			}
+			if (p >= end) {
+				return end;
+			}
+			p++;
+		} else if (*p == '/' && p + 1 < nl && p[1] == '/') {
+			return nl;
+		} else if (*p == '/' && p + 1 < nl && p[1] == '*') {
+			p = simd->find_char(p + 2, end, '*');
+			while (p + 1 < end && (*p != '*' || p[1] != '/')) {
+				p = simd->find_char(p + 1, end, '*');
+			}
+			if (p + 1 >= end) {
+				return end;
+			}
+			p += 2;
+		} else {
+			p++;
+			continue;
+		}
+		if (p > nl) {
+			nl = (const char *)memchr(p, '\n', end - p);
+			if (!nl) {
+				nl = end;
+			}
+		}
+	}
+
+}
+
+
+// true when [p, e) holds nothing but whitespace and comments. a block
+// comment left open isn't blank, parsing it reports the error.
+static bool jsonez_ndjson_blank(const jsonez_kernels *simd, const char *p, const char *e) {
+
+	for (;;) {
+		p = simd->skip_space(p, e);
+		if (p >= e) {
+			return true;
+		}
+		if (*p != '/' || e - p < 2) {
+			return false;
+		}
+		if (p[1] == '/') {
+			// a record ends at the newline that ends this
+			return true;
+		}
+		if (p[1] != '*') {
+			return false;
+		}
+		p = simd->find_char(p + 2, e, '*');
+		while (p + 1 < e && (*p != '*' || p[1] != '/')) {
+			p = simd->find_char(p + 1, e, '*');
+		}
+		if (p + 1 >= e) {
+			return false;
+		}
+		p += 2;
+	}
+
+}
+
+
+static void jsonez_ndjson_split(jsonez_ndjson_worker *w, const char *p) {
+
+	jsonez_ndjson_run *run = w->run;
+	w->start = p;
+	w->count = 0;
+	while (p < w->to) {
+		const char *e = jsonez_ndjson_end(run->simd, p, run->end);
+		if (!jsonez_ndjson_blank(run->simd, p, e)) {
+			if (w->count == w->size) {
+				size_t size = w->size ? w->size * 2 : 256;
+				jsonez_ndjson_item *items = (jsonez_ndjson_item *)realloc(w->items, size * sizeof(jsonez_ndjson_item));
+				if (!items) {
+					w->failed = true;
+					break;
+				}
+				w->items = items;
+				w->size = size;
+			}
+			jsonez_ndjson_item *item = &w->items[w->count++];
+			// the newline stays with the record, it ends a trailing comment
+			item->start = p;
+			item->end = e < run->end ? e + 1 : e;
+			item->json = NULL;
+			memset(&item->error, 0, sizeof(item->error));
+		}
+		p = e < run->end ? e + 1 : e;
+	}
+	w->next = p;
+
+}
+
+
+static void jsonez_ndjson_split_task(void *ctx, int worker) {
+
+	jsonez_ndjson_worker *w = (jsonez_ndjson_worker *)ctx + worker;
+	const char *p = w->from;
+	if (p > w->run->data && p[-1] != '\n') {
+		p = (const char *)memchr(p, '\n', w->run->end - p);
+		p = p ? p + 1 : w->run->end;
+	}
+	jsonez_ndjson_split(w, p);
+
+}
+
+
+static void jsonez_ndjson_deliver(jsonez_ndjson_worker *w, size_t i) {
+
+	jsonez_ndjson_run *run = w->run;
+	jsonez_ndjson_item *item = &w->items[i];
+	if (jsonez_flag_get(&run->stop)) {
+		jsonez_free(item->json);
+		return;
+	}
+	jsonez_record record;
+	record.index = w->first + i;
+	record.offset = item->start - run->data;
+	record.len = item->end - item->start;
+	record.json = item->json;
+	record.error = item->error;
+	if (!run->fn(run->user, &record)) {
+		jsonez_flag_set(&run->stop);
+	}
+
+}
+
+
+static void jsonez_ndjson_parse_task(void *ctx, int worker) {
+
+	jsonez_ndjson_worker *w = (jsonez_ndjson_worker *)ctx + worker;
+	jsonez_ndjson_run *run = w->run;
+	jsonez_parse_opts opts = { run->flags, NULL, NULL, 0, NULL };
+	for (size_t i = 0; i < w->count && !jsonez_flag_get(&run->stop); i++) {
+		jsonez_ndjson_item *item = &w->items[i];
+		jsonez_parser ps;
+		jsonez_parser_init(&ps, &opts);
+		ps.flags &= ~JSONEZ_PARSE_INSITU;
+		ps.base = item->start - run->data;
+		item->json = jsonez_parse_document(&ps, item->start, item->end - item->start);
+		item->error = ps.error;
+		if (run->unordered) {
+			jsonez_ndjson_deliver(w, i);
+		}
+	}
+
+}
+
+
+JSONEZDEF bool jsonez_parse_ndjson(const char *data, size_t len, jsonez_ndjson_opts *opts, jsonez_record_fn fn, void *user) {
+
+	if (data == NULL || len == 0)
+		return true;
+
+	jsonez_ndjson_run run;
+	memset(&run, 0, sizeof(run));
+	run.data = data;
+	run.end = data + len;
+	run.simd = jsonez_pick_kernels();
+	run.flags = opts ? opts->flags : 0;
+	run.unordered = opts && opts->unordered;
+	run.fn = fn;
+	run.user = user;
+
+	int count = jsonez_pool_size(opts ? opts->threads : 0);
+	jsonez_ndjson_worker *workers = (jsonez_ndjson_worker *)calloc(count, sizeof(jsonez_ndjson_worker));
+	jsonez_pool pool;
+	if (!workers || !jsonez_pool_start(&pool, count)) {
+		free(workers);
+		return false;
+	}
+	for (int i = 0; i < count; i++) {
+		workers[i].run = &run;
+	}
+
+	bool failed = false;
+	size_t index = 0;
+	const char *p = data;
+	while (p < run.end && !jsonez_flag_get(&run.stop) && !failed) {
+		for (int i = 0; i < count; i++) {
+			size_t offset = (size_t)i * JSONEZ_NDJSON_CHUNK;
+			jsonez_ndjson_worker *w = &workers[i];
+			w->from = offset < (size_t)(run.end - p) ? p + offset : run.end;
+			w->to = JSONEZ_NDJSON_CHUNK < (size_t)(run.end - w->from) ? w->from + JSONEZ_NDJSON_CHUNK : run.end;
+		}
+		jsonez_pool_each(&pool, jsonez_ndjson_split_task, workers);
+
+		// a chunk that guessed wrong where its first record starts
+		// gets split again from where the one before it ended
+		for (int i = 0; i < count; i++) {
+			jsonez_ndjson_worker *w = &workers[i];
+			const char *start = i ? workers[i - 1].next : p;
+			if (w->start != start) {
+				jsonez_ndjson_split(w, start);
+			}
+			failed |= w->failed;
+			w->first = index;
+			index += w->count;
+		}
+		if (failed) {
+			break;
+		}
+
+		jsonez_pool_each(&pool, jsonez_ndjson_parse_task, workers);
+		for (int i = 0; i < count; i++) {
+			jsonez_ndjson_worker *w = &workers[i];
+			for (size_t k = 0; k < w->count && !run.unordered; k++) {
+				jsonez_ndjson_deliver(w, k);
+			}
+		}
+		p = workers[count - 1].next;
+	}
+
+	jsonez_pool_stop(&pool);
+	for (int i = 0; i < count; i++) {
+		free(workers[i].items);
+	}
+	free(workers);
+	return !jsonez_flag_get(&run.stop) && !failed;
+
+}
+
+
+JSONEZDEF bool jsonez_parse_ndjson_file(const char *path, jsonez_ndjson_opts *opts, jsonez_record_fn fn, void *user) {
+
+	void *map;
+	size_t size;
+	if (!jsonez_map(path, false, &map, &size)) {
+		return false;
+	}
+	bool ok = jsonez_parse_ndjson((const char *)map, size, opts, fn, user);
+	jsonez_unmap(map, size);
+	return ok;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Stream parsing
+//
+// the same grammar as jsonez_parse_values, driven one token at a time so it
+// can stop wherever a chunk ends. a token cut off by the end of a chunk is
+// carried over and only as much of the next chunk as finishes it is
+// appended, the rest of that chunk is parsed where it is.
+
+
+struct jsonez_stream {
+
+	jsonez_parser ps;
+	jsonez_key key; // read, waiting for its value
+
+	// the start of a token the last chunk cut off
+	char *carry;
+	size_t carry_len;
+	size_t carry_size;
+	size_t resume; // how far into that token scanning got, so it isn't redone
+	size_t fed; // bytes so far, for error offsets
+
+	bool failed;
+	bool closed; // the root's brace closed, only comments may still come
+	bool ended; // a NUL ended the input, the rest is ignored
+
+};
+
+
+// true once the string at p closes before end. a backslash can't be left
+// behind as the resume point, its escape would be read as a quote.
+static bool jsonez_stream_string_end(jsonez_stream *st, const char *p, const char *end) {
+
+	const char *s = p + (st->resume ? st->resume : 1);
+	for (;;) {
+		s = st->ps.simd->find_quote(s, end);
+		if (s >= end) {
+			break;
+		}
+		if (*s != '\\') {
+			return true;
+		}
+		if (end - s < 2) {
+			break;
+		}
+		s += 2;
+	}
+	st->resume = s - p;
+	return false;
+
+}
+
+
+// p is at a '/'. returns past the comment, p itself when it is not one, or
+// null when the comment may go on past end.
+static const char *jsonez_stream_comment(jsonez_stream *st, const char *p, const char *end) {
+
+	if (end - p < 2) {
+		return NULL;
+	}
+	const char *s = p + (st->resume ? st->resume : 2);
+	if (p[1] == '/') {
+		s = st->ps.simd->find_char(s, end, '\n');
+		if (s < end) {
+			return s;
+		}
+	} else if (p[1] == '*') {
+		for (;;) {
+			s = st->ps.simd->find_char(s, end, '*');
+			if (end - s < 2) {
+				break;
+			}
+			if (s[1] == '/') {
+				return s + 2;
+			}
+			s++;
+		}
+	} else {
+		return p;
+	}
+	st->resume = s - p;
+	return NULL;
+
+}
+
+
+static const char *jsonez_stream_close(jsonez_stream *st, const char *p) {
+
+	jsonez_parser *ps = &st->ps;
+	jsonez_parse_close(ps, &ps->stack[--ps->depth]);
+	st->closed = !ps->depth;
+	return p + 1;
+
+}
+
+
+// consumes the token at p. returns p when it may go on past end, which
+// last says it can't, and null on errors.
+static const char *jsonez_stream_step(jsonez_stream *st, const char *p, const char *end, bool last) {
+
+	jsonez_parser *ps = &st->ps;
+	char c = *p;
+	if (!c && !ps->depth) {
+		// the input ended before the root started, as jsonez_parse_n says
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Syntax Error", p);
+		return 0;
+	}
+	if (!c) {
+		st->ended = true;
+		return p + 1;
+	}
+
+	if (!ps->depth) {
+		// the first token decides between a braced and a braceless root
+		jsonez *root = &ps->doc->root;
+		if (!jsonez_parse_push(ps, root, c == '{' ? JSONEZ_IN_OBJECT : JSONEZ_IN_ROOT)) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+			return 0;
+		}
+		if (c == '{') {
+			return p + 1;
+		}
+	}
+
+	jsonez_frame *top = &ps->stack[ps->depth - 1];
+	jsonez *parent = top->node;
+	const char *q;
+
+	switch (top->expect) {
+	case JSONEZ_EXPECT_NEXT_KEY:
+		if (c != '"' && c != '}' && c != ']' && !JSONEZ_RAW_KEY(c)) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Unexptected end of file", p);
+			return 0;
+		}
+		top->expect = JSONEZ_EXPECT_KEY;
+		// fall through
+
+	case JSONEZ_EXPECT_KEY:
+		if (c == '}' && top->kind == JSONEZ_IN_OBJECT) {
+			return jsonez_stream_close(st, p);
+		}
+		if (c == '"' || JSONEZ_RAW_KEY(c)) {
+			if (c == '"') {
+				if (!last && !jsonez_stream_string_end(st, p, end)) {
+					return p;
+				}
+				q = jsonez_parse_quote_key(ps, &st->key, p);
+			} else {
+				for (q = p; q < end && JSONEZ_RAW_KEY(*q); q++);
+				if (q == end && !last) {
+					return p;
+				}
+				if (!jsonez_parse_intern(ps, &st->key, p, q - p)) {
+					return 0;
+				}
+			}
+			if (q) {
+				top->expect = JSONEZ_EXPECT_SEP;
+			}
+			return q;
+		}
+		// no key at all, which the tree parser takes too
+		memset(&st->key, 0, sizeof(st->key));
+		top->expect = JSONEZ_EXPECT_SEP;
+		// fall through
+
+	case JSONEZ_EXPECT_SEP:
+		if (c == ':' || c == '=') {
+			top->expect = JSONEZ_EXPECT_VALUE;
+			return p + 1;
+		}
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Missing ':' key separator", p);
+		return 0;
+
+	case JSONEZ_EXPECT_NEXT:
+		if (c == ',') {
+			top->expect = top->kind == JSONEZ_IN_ARRAY ? JSONEZ_EXPECT_VALUE : JSONEZ_EXPECT_NEXT_KEY;
+			return p + 1;
+		}
+		if (top->kind != JSONEZ_IN_ARRAY) {
+			if (c == '}' && top->kind == JSONEZ_IN_OBJECT) {
+				return jsonez_stream_close(st, p);
+			}
+			if (c == '}' || c == ']') {
+				// the tree reads a stray bracket as a missing key
+				top->expect = JSONEZ_EXPECT_KEY;
+				return jsonez_stream_step(st, p, end, last);
+			}
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Next item missing", p);
+			return 0;
+		}
+		// array items don't need the comma
+		break;
+
+	case JSONEZ_EXPECT_VALUE:
+		break;
+	}
+
+	if (c == ']' && top->kind == JSONEZ_IN_ARRAY) {
+		return jsonez_stream_close(st, p);
+	}
+	jsonez_key *key = top->kind == JSONEZ_IN_ARRAY ? NULL : &st->key;
+
+	if (c == 't' || c == 'f') {
+		if (end - p < (c == 't' ? 4 : 5) && !last) {
+			return p;
+		}
+		q = jsonez_parse_bool_value(ps, parent, key, p);
+	} else if (c == '"') {
+		if (!last && !jsonez_stream_string_end(st, p, end)) {
+			return p;
+		}
+		q = jsonez_parse_string_value(ps, parent, key, p);
+	} else if (JSONEZ_NUMBER(c)) {
+		for (q = p; q < end && JSONEZ_NUMBER(*q); q++);
+		if (q == end && !last) {
+			return p;
+		}
+		q = jsonez_parse_number_value(ps, parent, key, p);
+	} else if (c == '{' || c == '[') {
+		jsonez *child = jsonez_parse_create(ps, parent, key, p);
+		if (!child) {
+			return 0;
+		}
+		top->expect = JSONEZ_EXPECT_NEXT;
+		if (!jsonez_parse_push(ps, child, c == '{' ? JSONEZ_IN_OBJECT : JSONEZ_IN_ARRAY)) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_MEMORY, "Out of memory", p);
+			return 0;
+		}
+		return p + 1;
+	} else {
+		if (top->kind == JSONEZ_IN_ARRAY) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Neverending Array", p);
+		} else {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Unknow Value type", p);
+		}
+		return 0;
+	}
+	if (q) {
+		top->expect = JSONEZ_EXPECT_NEXT;
+	}
+	return q;
+
+}
+
+
+// parses [p, end) and returns where the token that needs more input starts
+static const char *jsonez_stream_run(jsonez_stream *st, const char *p, const char *end, bool last) {
+
+	jsonez_parser *ps = &st->ps;
+	ps->end = end;
+
+	while (!st->failed && !st->ended) {
+		if (last) {
+			p = jsonez_skip_whitespace(ps, p);
+		} else {
+			if (p < end && *p && JSONEZ_WHITESPACE(*p)) {
+				p = ps->simd->skip_space(p + 1, end);
+			}
+			if (p < end && *p == '/') {
+				const char *q = jsonez_stream_comment(st, p, end);
+				if (!q) {
+					return p;
+				}
+				if (q != p) {
+					st->resume = 0;
+					p = q;
+					continue;
+				}
+			}
+		}
+		if (p >= end) {
+			break;
+		}
+		if (st->closed) {
+			// like jsonez_parse_n, only a NUL may follow the root
+			if (*p) {
+				JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Text after the root", p);
+				st->failed = true;
+			}
+			st->ended = true;
+			break;
+		}
+
+		const char *q = jsonez_stream_step(st, p, end, last);
+		if (!q) {
+			st->failed = true;
+			break;
+		}
+		if (q == p) {
+			return p;
+		}
+		st->resume = 0;
+		p = q;
+	}
+	return p;
+
+}
+
+
+static bool jsonez_stream_carry(jsonez_stream *st, const char *data, size_t len) {
+
+	size_t need = st->carry_len + len;
+	if (need > st->carry_size) {
+		size_t size = st->carry_size ? st->carry_size : 256;
+		while (size < need) {
+			size *= 2;
+		}
+		char *carry = (char *)realloc(st->carry, size);
+		if (!carry) {
+			return false;
+		}
+		st->carry = carry;
+		st->carry_size = size;
+	}
+	memcpy(st->carry + st->carry_len, data, len);
+	st->carry_len = need;
+	return true;
+
+}
+
+
+JSONEZDEF jsonez_stream *jsonez_stream_new(jsonez_parse_opts *opts) {
+
+	jsonez_stream *st = (jsonez_stream *)calloc(1, sizeof(jsonez_stream));
+	if (!st) {
+		return NULL;
+	}
+	jsonez_parser_init(&st->ps, opts);
+	// chunks go away after feed, so everything gets copied out of them
+	st->ps.flags &= ~JSONEZ_PARSE_INSITU;
+	if (!jsonez_parse_root(&st->ps)) {
+		free(st);
+		return NULL;
+	}
+	return st;
+
+}
+
+
+JSONEZDEF bool jsonez_stream_feed(jsonez_stream *st, const char *chunk, size_t len) {
+
+	if (st->failed || st->ended || !len) {
+		return !st->failed;
+	}
+
+	// a carried token gets pieces of the chunk, growing, until it is done.
+	// once the parse gets past it the chunk is picked up in place.
+	const char *p = chunk;
+	const char *end = chunk + len;
+	size_t held = st->carry_len;
+	size_t piece = held < 64 ? 64 : held;
+	while (st->carry_len) {
+		size_t take = (size_t)(end - p) < piece ? (size_t)(end - p) : piece;
+		if (!jsonez_stream_carry(st, p, take)) {
+			JSONEZ_ERROR(&st->ps, JSONEZ_ERROR_MEMORY, "Out of memory", NULL);
+			st->failed = true;
+			return false;
+		}
+		p += take;
+		piece *= 2;
+		st->ps.begin = st->carry;
+		st->ps.base = st->fed - held;
+		const char *q = jsonez_stream_run(st, st->carry, st->carry + st->carry_len, false);
+		if (st->failed || st->ended) {
+			st->fed += len;
+			return !st->failed;
+		}
+		if (q != st->carry) {
+			// the carried token is done, everything after it is in the chunk too
+			p = chunk + (q - st->carry - held);
+			st->carry_len = 0;
+		} else if (p == end) {
+			st->fed += len;
+			return true;
+		}
+	}
+
+	st->ps.begin = chunk;
+	st->ps.base = st->fed;
+	st->fed += len;
+	p = jsonez_stream_run(st, p, end, false);
+	size_t left = end - p;
+	if (left && !st->failed && !st->ended && !jsonez_stream_carry(st, p, left)) {
+		JSONEZ_ERROR(&st->ps, JSONEZ_ERROR_MEMORY, "Out of memory", NULL);
+		st->failed = true;
+	}
+	return !st->failed;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_stream_finish(jsonez_stream *st) {
+
+	jsonez_parser *ps = &st->ps;
+	ps->begin = ps->end = st->carry;
+	ps->base = st->fed - st->carry_len;
+	if (!st->failed && !st->ended && st->carry_len) {
+		jsonez_stream_run(st, st->carry, st->carry + st->carry_len, true);
+	}
+
+	// something came but none of it was a value, while no input at all is
+	// an empty object
+	if (!st->failed && !st->ended && !st->closed && !ps->depth && st->fed) {
+		JSONEZ_ERROR(ps, JSONEZ_ERROR_SYNTAX, "Syntax Error", NULL);
+	}
+
+	// only a braceless root can end with the input, and not inside an item
+	if (!st->failed && !st->ended && ps->depth) {
+		jsonez_frame *top = &ps->stack[ps->depth - 1];
+		if (top->expect == JSONEZ_EXPECT_SEP) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_KEY, "Missing ':' key separator", ps->end);
+		} else if (ps->depth > 1 || top->kind != JSONEZ_IN_ROOT || top->expect == JSONEZ_EXPECT_VALUE) {
+			JSONEZ_ERROR(ps, JSONEZ_ERROR_EOF, "Unexpected end of file", NULL);
+		}
+	}
+
+	jsonez *json = jsonez_parse_done(ps);
+	free(st->carry);
+	free(st);
+	return json;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Lazy cursors
+//
+// the doc only borrows the parser for its scanners and scratch memory.
+// skipping a value doesn't check it, so a broken subtree nobody asks for
+// goes unnoticed.
+
+
+struct jsonez_doc {
+
+	jsonez_parser ps;
+	const char *data;
+
+};
+
+
+// p is on the opening quote, returns past the closing one
+static const char *jsonez_lazy_string_end(jsonez_doc *doc, const char *p) {
+
+	jsonez_parser *ps = &doc->ps;
+	for (p++;;) {
+		p = ps->simd->find_quote(p, ps->end);
+		if (p >= ps->end || !*p) {
+			return NULL;
+		}
+		if (*p == '"') {
+			return p + 1;
+		}
+		p += 2;
+	}
+
+}
+
+
+// returns past the value at p, null if it runs off the end
+static const char *jsonez_lazy_skip(jsonez_doc *doc, const char *p) {
+
+	jsonez_parser *ps = &doc->ps;
+	const char *end = ps->end;
+	char c = JSONEZ_AT(ps, p);
+	if (c == '"') {
+		return jsonez_lazy_string_end(doc, p);
+	}
+	if (c != '{' && c != '[') {
+		while (p < end && (JSONEZ_RAW_KEY(*p) || JSONEZ_NUMBER(*p))) {
+			p++;
+		}
+		return p;
+	}
+
+	// bracket kinds aren't matched up, only counted
+	size_t depth = 0;
+	for (;;) {
+		p = ps->simd->find_structural(p, end);
+		if (p >= end || !*p) {
+			return NULL;
+		}
+		c = *p;
+		if (c == '"') {
+			p = jsonez_lazy_string_end(doc, p);
+			if (!p) {
+				return NULL;
+			}
+		} else if (c == '/') {
+			const char *q = jsonez_skip_whitespace(ps, p);
+			p = q == p ? p + 1 : q;
+		} else if (c == '{' || c == '[') {
+			depth++;
+			p++;
+		} else {
+			p++;
+			if (--depth == 0) {
+				return p;
+			}
+		}
+	}
+
+}
+
+
+// p is where an object member should start, item ends up on its value
+static bool jsonez_lazy_member(jsonez_doc *doc, const char *p, jsonez_cursor *item) {
+
+	jsonez_parser *ps = &doc->ps;
+	p = jsonez_skip_whitespace(ps, p);
+	const char *key = p;
+	char c = JSONEZ_AT(ps, p);
+	if (c == '"') {
+		p = jsonez_lazy_string_end(doc, p);
+		if (!p) {
+			return false;
+		}
+	} else if (JSONEZ_RAW_KEY(c)) {
+		while (p < ps->end && JSONEZ_RAW_KEY(*p)) {
+			p++;
+		}
+	} else {
+		return false;
+	}
+	p = jsonez_skip_key_separator(ps, p);
+	if (!p) {
+		return false;
+	}
+	item->doc = doc;
+	item->key = key;
+	item->p = p;
+	item->root = false;
+	return true;
+
+}
+
+
+static bool jsonez_lazy_item(jsonez_doc *doc, const char *p, jsonez_cursor *item) {
+
+	jsonez_parser *ps = &doc->ps;
+	p = jsonez_skip_whitespace(ps, p);
+	char c = JSONEZ_AT(ps, p);
+	if (!(c == '{' || c == '[' || c == '"' || c == 't' || c == 'f' || JSONEZ_NUMBER(c))) {
+		return false;
+	}
+	item->doc = doc;
+	item->key = NULL;
+	item->p = p;
+	item->root = false;
+	return true;
+
+}
+
+
+static bool jsonez_lazy_number(jsonez_cursor *cursor, jsonez *num) {
+
+	jsonez_parser *ps = &cursor->doc->ps;
+	if (cursor->root || !JSONEZ_NUMBER(JSONEZ_AT(ps, cursor->p))) {
+		return false;
+	}
+	num->type = JSON_NUMBER;
+	num->flags = 0;
+	const char *e = jsonez_scan_number(cursor->p, ps->end, num);
+	return e && !(e < ps->end && JSONEZ_NUMBER(*e)) && num->n - num->n == 0;
+
+}
+
+
+JSONEZDEF jsonez_doc *jsonez_doc_open(const char *data, size_t len) {
+
+	jsonez_doc *doc = (jsonez_doc *)malloc(sizeof(jsonez_doc));
+	if (!doc) {
+		return NULL;
+	}
+	jsonez_parser_init(&doc->ps, NULL);
+	doc->ps.end = data + len;
+	doc->data = data;
+	return doc;
+
+}
+
+
+JSONEZDEF void jsonez_doc_close(jsonez_doc *doc) {
+
+	if (doc) {
+		free(doc->ps.scratch);
+		free(doc);
+	}
+
+}
+
+
+// the root is an object either way, braceless ones start at their first key
+JSONEZDEF jsonez_cursor jsonez_doc_root(jsonez_doc *doc) {
+
+	jsonez_cursor root;
+	root.doc = doc;
+	root.key = NULL;
+	root.p = jsonez_skip_whitespace(&doc->ps, doc->data);
+	root.root = true;
+	return root;
+
+}
+
+
+JSONEZDEF jsonez_type jsonez_cursor_type(jsonez_cursor *cursor) {
+
+	if (cursor->root) {
+		return JSON_OBJ;
+	}
+	char c = JSONEZ_AT(&cursor->doc->ps, cursor->p);
+	if (c == '{') return JSON_OBJ;
+	if (c == '[') return JSON_ARRAY;
+	if (c == '"') return JSON_STRING;
+	if (c == 't' || c == 'f') return JSON_BOOL;
+	if (JSONEZ_NUMBER(c)) return JSON_NUMBER;
+	return JSON_UNKNOWN;
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_child(jsonez_cursor *parent, jsonez_cursor *child) {
+
+	jsonez_doc *doc = parent->doc;
+	const char *p = parent->p;
+	switch (jsonez_cursor_type(parent)) {
+	case JSON_OBJ:
+		return jsonez_lazy_member(doc, p + (JSONEZ_AT(&doc->ps, p) == '{'), child);
+	case JSON_ARRAY:
+		return jsonez_lazy_item(doc, p + 1, child);
+	default:
+		return false;
+	}
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_next(jsonez_cursor *cursor) {
+
+	if (cursor->root) {
+		return false;
+	}
+	jsonez_doc *doc = cursor->doc;
+	const char *p = jsonez_lazy_skip(doc, cursor->p);
+	if (!p) {
+		return false;
+	}
+	p = jsonez_skip_whitespace(&doc->ps, p);
+	bool comma = JSONEZ_AT(&doc->ps, p) == ',';
+	if (cursor->key) {
+		return comma && jsonez_lazy_member(doc, p + 1, cursor);
+	}
+	// array items don't need the comma
+	return jsonez_lazy_item(doc, p + comma, cursor);
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_key(jsonez_cursor *cursor, const char **key, size_t *len) {
+
+	const char *p = cursor->key;
+	if (!p) {
+		return false;
+	}
+	if (*p == '"') {
+		return jsonez_scan_string(&cursor->doc->ps, p, key, len) != NULL;
+	}
+	const char *e = p;
+	while (e < cursor->doc->ps.end && JSONEZ_RAW_KEY(*e)) {
+		e++;
+	}
+	*key = p;
+	*len = e - p;
+	return true;
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_find_field(jsonez_cursor *object, const char *key, jsonez_cursor *field) {
+
+	size_t len = strlen(key);
+	jsonez_cursor item;
+	if (jsonez_cursor_type(object) != JSON_OBJ || !jsonez_cursor_child(object, &item)) {
+		return false;
+	}
+	do {
+		const char *s;
+		size_t n;
+		if (jsonez_cursor_key(&item, &s, &n) && n == len && !memcmp(s, key, len)) {
+			*field = item;
+			return true;
+		}
+	} while (jsonez_cursor_next(&item));
+	return false;
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_get_string(jsonez_cursor *cursor, const char **s, size_t *len) {
+
+	if (jsonez_cursor_type(cursor) != JSON_STRING) {
+		return false;
+	}
+	return jsonez_scan_string(&cursor->doc->ps, cursor->p, s, len) != NULL;
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_get_double(jsonez_cursor *cursor, double *value) {
+
+	jsonez num;
+	if (!jsonez_lazy_number(cursor, &num)) {
+		return false;
+	}
+	*value = num.n;
+	return true;
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_get_int64(jsonez_cursor *cursor, int64_t *value) {
+
+	jsonez num;
+	return jsonez_lazy_number(cursor, &num) && jsonez_get_int64(&num, value);
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_get_uint64(jsonez_cursor *cursor, uint64_t *value) {
+
+	jsonez num;
+	return jsonez_lazy_number(cursor, &num) && jsonez_get_uint64(&num, value);
+
+}
+
+
+JSONEZDEF bool jsonez_cursor_get_bool(jsonez_cursor *cursor, bool *value) {
+
+	jsonez_parser *ps = &cursor->doc->ps;
+	const char *p = cursor->p;
+	size_t left = cursor->root ? 0 : ps->end - p;
+	if (left >= 4 && !memcmp(p, "true", 4)) {
+		*value = true;
+		return true;
+	}
+	if (left >= 5 && !memcmp(p, "false", 5)) {
+		*value = false;
+		return true;
+	}
+	return false;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_find(jsonez *parent, const char *key) {
+
+	if (parent == NULL || key == NULL)
+		return NULL;
+
+	// numbers keep their integer where objects keep the index
+	if (parent->type == JSON_NUMBER)
+		return NULL;
+
+	size_t len = strlen(key);
+	unsigned int hash = jsonez_hash(key, len);
+
+	if (!parent->index && parent->type == JSON_OBJ && parent->i >= JSONEZ_INDEX_THRESHOLD && !(parent->flags & JSONEZ_NODE_ARENA)) {
+		jsonez_index_build(NULL, parent);
+	}
+	// arrays keep their item table there instead
+	if (parent->index && parent->type == JSON_OBJ) {
+		return jsonez_index_lookup(parent->index, key, len, hash);
+	}
+
+	// the length and hash weed out nearly everything before memcmp
+	jsonez *next = parent->child;
+	while(next) {
+		if(jsonez_key_equals(next, key, len, hash)) {
+			return next;
+		}
+		next = next->next;
+	}
+	return NULL;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_at(jsonez *array, size_t i) {
+
+	if (array == NULL || array->type != JSON_ARRAY || i >= (size_t)array->i)
+		return NULL;
+
+	if (!array->items && array->i >= JSONEZ_INDEX_THRESHOLD && !(array->flags & JSONEZ_NODE_ARENA)) {
+		jsonez_items_build(NULL, array);
+	}
+	if (array->items) {
+		return array->items->at[i];
+	}
+
+	// short arrays get walked from whichever end is closer
+	size_t n = (size_t)array->i;
+	jsonez *item = array->child;
+	if (i < n / 2) {
+		while (i--) {
+			item = item->next;
+		}
+	} else {
+		item = item->prev;
+		for (size_t k = n - 1; k > i; k--) {
+			item = item->prev;
+		}
+	}
+	return item;
+
+}
+
+
+JSONEZDEF size_t jsonez_size(jsonez *json) {
+
+	if (json == NULL || (json->type != JSON_ARRAY && json->type != JSON_OBJ))
+		return 0;
+	return (size_t)json->i;
+
+}
+
+
+JSONEZDEF bool jsonez_get_int64(jsonez *json, int64_t *value) {
+
+	if (!json || json->type != JSON_NUMBER || (json->flags & JSONEZ_NODE_UINT)) {
+		return false;
+	}
+	if (json->flags & JSONEZ_NODE_INT) {
+		*value = json->i64;
+		return true;
+	}
+
+	// 2^63 is exact as a double, INT64_MAX is not
+	double n = json->n;
+	if (n >= -9223372036854775808.0 && n < 9223372036854775808.0 && n == (double)(int64_t)n) {
+		*value = (int64_t)n;
+		return true;
+	}
+	return false;
+
+}
+
+
+JSONEZDEF bool jsonez_get_uint64(jsonez *json, uint64_t *value) {
+
+	if (!json || json->type != JSON_NUMBER) {
+		return false;
+	}
+	if (json->flags & (JSONEZ_NODE_INT | JSONEZ_NODE_UINT)) {
+		if ((json->flags & JSONEZ_NODE_INT) && json->i64 < 0) {
+			return false;
+		}
+		*value = json->u64;
+		return true;
+	}
+
+	double n = json->n;
+	if (n >= 0 && n < 18446744073709551616.0 && n == (double)(uint64_t)n) {
+		*value = (uint64_t)n;
+		return true;
+	}
+	return false;
+
+}
+
+
+JSONEZDEF bool jsonez_get_double(jsonez *json, double *value) {
+
+	if (!json || json->type != JSON_NUMBER) {
+		return false;
+	}
+	*value = json->n;
+	return true;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_root() {
+
+	jsonez *obj = (jsonez *)calloc(1, sizeof(jsonez));
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_OBJ;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_object(jsonez *parent, char *key) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_OBJ;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_array(jsonez *parent, char *key) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_ARRAY;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_bool(jsonez *parent, char *key, bool value) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_BOOL;
+	obj->i = value;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_numd(jsonez *parent, char *key, double value) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_NUMBER;
+	obj->n = value;
+	return obj;
+
+}
+
+JSONEZDEF jsonez *jsonez_create_numf(jsonez *parent, char *key, float value) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_NUMBER;
+	obj->n = value;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_numi(jsonez *parent, char *key, int value) {
+
+	return jsonez_create_int64(parent, key, value);
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_int64(jsonez *parent, char *key, int64_t value) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_NUMBER;
+	obj->flags |= JSONEZ_NODE_INT;
+	obj->n = (double)value;
+	obj->i64 = value;
+	return obj;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_create_uint64(jsonez *parent, char *key, uint64_t value) {
+
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_NUMBER;
+	obj->flags |= value <= INT64_MAX ? JSONEZ_NODE_INT : JSONEZ_NODE_UINT;
+	obj->n = (double)value;
+	obj->u64 = value;
+	return obj;
 
 }
 
 
 JSONEZDEF jsonez *jsonez_create_string(jsonez *parent, char *key, char *value) {
 
-	// this needs to unescape the string because
-	// reading the strings in escapes them
-	// why is this so hard?
-	jsonez *obj = jsonez_create(parent, key);
-	obj->type = JSON_STRING;
-	// count neede chars with escaping
-	int size = 0;
-	char *p = value;
-	while(p && *p) {
-		size++;
-		switch(*p) {
-			case '"':
-			case '\\':
-			case '\b':
-			case '\f':
-			case '\n':
-			case '\r':
-			case '\t':
-				size++;
-				break;
-		}	
-		p++;
+	// this needs to unescape the string because
+	// reading the strings in escapes them
+	// why is this so hard?
+	jsonez *obj = jsonez_create(NULL, parent, key);
+	if (!obj) {
+		return NULL;
+	}
+	obj->type = JSON_STRING;
+	// count neede chars with escaping
+	int size = 0;
+	char *p = value;
+	while(p && *p) {
+		size++;
+		switch(*p) {
+			case '"':
+			case '\\':
+			case '\b':
+			case '\f':
+			case '\n':
+			case '\r':
+			case '\t':
+				size++;
+				break;
+		}	
+		p++;
+	}
+
+	obj->s = (char *)calloc(size + 1, sizeof(char));
+	if (!obj->s) {
+		jsonez_free(parent ? jsonez_detach(parent, obj) : obj);
+		return NULL;
+	}
+	p = value;
+	char *dest = obj->s;
+	while (p && *p) {
+		switch(*p) {
+			case '"':
+			case '\\':
+			case '\b':
+			case '\f':
+			case '\n':
+			case '\r':
+			case '\t':
+				*dest++ = '\\';
+				break;
+		}	
+		*dest++ = *p++;
+	}
+
+	obj->s[size] = '\0';
+	return obj;
+
+}
+
+
+// json and everything below it stop pointing into the key pool or the
+// input of the document they were parsed into. arena nodes go with their
+// arena whatever they point at, so they are left alone.
+static bool jsonez_own(jsonez *json) {
+
+	if (!(json->flags & JSONEZ_NODE_ARENA)) {
+		if (json->key && (json->flags & JSONEZ_NODE_KEY_BORROWED)) {
+			char *key = (char *)malloc(json->key_len + 1);
+			if (!key) {
+				return false;
+			}
+			memcpy(key, json->key, json->key_len + 1);
+			json->key = key;
+			json->flags &= ~JSONEZ_NODE_KEY_BORROWED;
+		}
+		if (json->type == JSON_STRING && (json->flags & JSONEZ_NODE_STR_BORROWED)) {
+			char *str = jsonez_strdup(NULL, json->s);
+			if (!str) {
+				return false;
+			}
+			json->s = str;
+			json->flags &= ~JSONEZ_NODE_STR_BORROWED;
+		}
+	}
+	for (jsonez *child = json->child; child; child = child->next) {
+		if (!jsonez_own(child)) {
+			return false;
+		}
+	}
+	return true;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_detach(jsonez *parent, jsonez *child) {
+
+	if (parent == NULL || child == NULL)
+		return NULL;
+
+	if (!jsonez_own(child)) {
+		return NULL;
+	}
+	jsonez_unlink(parent, child);
+	return child;
+
+}
+
+
+JSONEZDEF void jsonez_delete(jsonez *parent, jsonez *child) {
+
+	if (parent == NULL || child == NULL)
+		return;
+
+	jsonez_unlink(parent, child);
+	jsonez_free(child);
+
+}
+
+
+JSONEZDEF jsonez *jsonez_insert_before(jsonez *parent, jsonez *before, jsonez *item) {
+
+	if (parent == NULL || item == NULL)
+		return NULL;
+
+	jsonez_link(NULL, parent, before, item);
+	return item;
+
+}
+
+
+static void jsonez_out_grow(jsonez_output *out, size_t n) {
+
+	size_t cap = out->cap ? out->cap : 256;
+	while (cap < out->len + n) {
+		cap *= 2;
+	}
+	char *buf = (char *)realloc(out->buf, cap);
+	if (!buf) {
+		out->failed = true;
+		out->grow = false;
+		return;
+	}
+	out->buf = buf;
+	out->cap = cap;
+
+}
+
+
+static bool jsonez_out_flush(jsonez_output *out) {
+
+	if (out->len && !out->failed && !out->sink->write(out->sink->user, out->buf, out->len)) {
+		out->failed = true;
+	}
+	out->len = 0;
+	return !out->failed;
+
+}
+
+
+// the staging buffer is full, send it on and start over. anything bigger
+// than the buffer goes straight through.
+static void jsonez_out_spill(jsonez_output *out, const char *s, size_t n) {
+
+	if (!jsonez_out_flush(out)) {
+		return;
+	}
+	if (n >= out->cap) {
+		out->failed = !out->sink->write(out->sink->user, s, n);
+		return;
+	}
+	memcpy(out->buf, s, n);
+	out->len = n;
+
+}
+
+
+static void jsonez_out_write(jsonez_output *out, const char *s, size_t n) {
+
+	if (n == 0) {
+		return;
+	}
+	if (out->len + n > out->cap) {
+		if (out->sink) {
+			jsonez_out_spill(out, s, n);
+			return;
+		}
+		if (out->grow) {
+			jsonez_out_grow(out, n);
+		}
+		if (out->len + n > out->cap) {
+			// a fixed buffer takes what fits and counts the rest
+			if (out->len < out->cap) {
+				memcpy(out->buf + out->len, s, out->cap - out->len);
+			}
+			out->len += n;
+			return;
+		}
+	}
+	memcpy(out->buf + out->len, s, n);
+	out->len += n;
+
+}
+
+
+static void jsonez_out_char(jsonez_output *out, char c) {
+
+	if (out->len < out->cap) {
+		out->buf[out->len++] = c;
+	} else {
+		jsonez_out_write(out, &c, 1);
+	}
+
+}
+
+
+static void jsonez_out_string(jsonez_output *out, const char *s) {
+
+	jsonez_out_write(out, s, strlen(s));
+
+}
+
+
+static void jsonez_out_indent(jsonez_output *out, int space) {
+
+	static const char spaces[] = "                                                                ";
+	while (space > 0) {
+		int n = space < (int)sizeof(spaces) - 1 ? space : (int)sizeof(spaces) - 1;
+		jsonez_out_write(out, spaces, n);
+		space -= n;
+	}
+
+}
+
+
+static void jsonez_print_array_values(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
+
+	jsonez_out_write(out, " [", 2);
+	jsonez *arr_obj = obj->child;
+	if (arr_obj) {
+		jsonez_print_value(out, space, arr_obj, ctx);
+		while(arr_obj->next) {
+			arr_obj = arr_obj->next;
+			jsonez_out_write(out, ", ", 2);
+			jsonez_print_value(out, space, arr_obj, ctx);
+		}
+	}
+	jsonez_out_char(out, ']');
+}
+
+
+static void jsonez_print_object_values(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
+	jsonez_out_write(out, "{\n", 2);
+	if (obj) {
+		jsonez *child = obj->child;
+		if (child) {
+			jsonez_print_key_value(out, space + ctx->indent_length, child, ctx);
+			while(child->next) {
+				jsonez_out_write(out, ",\n", 2);
+				child = child->next;
+				jsonez_print_key_value(out, space + ctx->indent_length, child, ctx);
+			}
+		}
+	}
+	jsonez_out_char(out, '\n');
+	jsonez_out_indent(out, space);
+	jsonez_out_char(out, '}');
+}
+
+
+static bool jsonez_is_key_raw(char *key) {
+	while(key && *key) {
+		if (!JSONEZ_RAW_KEY(*key)) {
+			return false;
+		}
+		key++;
+	}
+	return true;
+}
+
+
+static void jsonez_write_key(jsonez_output *out, int space, char *key, size_t key_len, jsonez_ctx *ctx) {
+	jsonez_out_indent(out, space);
+	if (ctx->quote_keys || !jsonez_is_key_raw(key)) {
+		jsonez_out_char(out, '"');
+		jsonez_out_write(out, key, key_len);
+		jsonez_out_char(out, '"');
+	} else {
+		jsonez_out_write(out, key, key_len);
+	}
+	if (ctx->use_equal_sign) {
+		jsonez_out_write(out, " = ", 3);
+	} else {
+		jsonez_out_write(out, ": ", 2);
+	}
+}
+
+
+static void jsonez_write_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
+	jsonez_write_key(out, space, obj->key, obj->key ? obj->key_len : 0, ctx);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Number formatting
+//
+// doubles are written with Grisu2, the shortest digits that read back as
+// the same double in nearly every case and never more than 17 of them.
+// integers, and doubles that are whole and exact, skip all of that.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define JSONEZ_NUMBER_MAX 32 // longest output, with room to spare
+
+typedef struct jsonez_diyfp {
+
+	uint64_t f;
+	int e;
+
+} jsonez_diyfp;
+
+
+typedef struct jsonez_cached_power {
+
+	uint64_t f;
+	int e;
+	int k;
+
+} jsonez_cached_power;
+
+
+// 10^k for k in -300..324 by 8, normalized to 64 bits and rounded
+static const jsonez_cached_power jsonez_cached_powers[] = {
+	{ 0xAB70FE17C79AC6CAULL, -1060, -300 }, { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+	{ 0xBE5691EF416BD60CULL, -1007, -284 }, { 0x8DD01FAD907FFC3CULL, -980, -276 },
+	{ 0xD3515C2831559A83ULL, -954, -268 }, { 0x9D71AC8FADA6C9B5ULL, -927, -260 },
+	{ 0xEA9C227723EE8BCBULL, -901, -252 }, { 0xAECC49914078536DULL, -874, -244 },
+	{ 0x823C12795DB6CE57ULL, -847, -236 }, { 0xC21094364DFB5637ULL, -821, -228 },
+	{ 0x9096EA6F3848984FULL, -794, -220 }, { 0xD77485CB25823AC7ULL, -768, -212 },
+	{ 0xA086CFCD97BF97F4ULL, -741, -204 }, { 0xEF340A98172AACE5ULL, -715, -196 },
+	{ 0xB23867FB2A35B28EULL, -688, -188 }, { 0x84C8D4DFD2C63F3BULL, -661, -180 },
+	{ 0xC5DD44271AD3CDBAULL, -635, -172 }, { 0x936B9FCEBB25C996ULL, -608, -164 },
+	{ 0xDBAC6C247D62A584ULL, -582, -156 }, { 0xA3AB66580D5FDAF6ULL, -555, -148 },
+	{ 0xF3E2F893DEC3F126ULL, -529, -140 }, { 0xB5B5ADA8AAFF80B8ULL, -502, -132 },
+	{ 0x87625F056C7C4A8BULL, -475, -124 }, { 0xC9BCFF6034C13053ULL, -449, -116 },
+	{ 0x964E858C91BA2655ULL, -422, -108 }, { 0xDFF9772470297EBDULL, -396, -100 },
+	{ 0xA6DFBD9FB8E5B88FULL, -369, -92 }, { 0xF8A95FCF88747D94ULL, -343, -84 },
+	{ 0xB94470938FA89BCFULL, -316, -76 }, { 0x8A08F0F8BF0F156BULL, -289, -68 },
+	{ 0xCDB02555653131B6ULL, -263, -60 }, { 0x993FE2C6D07B7FACULL, -236, -52 },
+	{ 0xE45C10C42A2B3B06ULL, -210, -44 }, { 0xAA242499697392D3ULL, -183, -36 },
+	{ 0xFD87B5F28300CA0EULL, -157, -28 }, { 0xBCE5086492111AEBULL, -130, -20 },
+	{ 0x8CBCCC096F5088CCULL, -103, -12 }, { 0xD1B71758E219652CULL, -77, -4 },
+	{ 0x9C40000000000000ULL, -50, 4 }, { 0xE8D4A51000000000ULL, -24, 12 },
+	{ 0xAD78EBC5AC620000ULL, 3, 20 }, { 0x813F3978F8940984ULL, 30, 28 },
+	{ 0xC097CE7BC90715B3ULL, 56, 36 }, { 0x8F7E32CE7BEA5C70ULL, 83, 44 },
+	{ 0xD5D238A4ABE98068ULL, 109, 52 }, { 0x9F4F2726179A2245ULL, 136, 60 },
+	{ 0xED63A231D4C4FB27ULL, 162, 68 }, { 0xB0DE65388CC8ADA8ULL, 189, 76 },
+	{ 0x83C7088E1AAB65DBULL, 216, 84 }, { 0xC45D1DF942711D9AULL, 242, 92 },
+	{ 0x924D692CA61BE758ULL, 269, 100 }, { 0xDA01EE641A708DEAULL, 295, 108 },
+	{ 0xA26DA3999AEF774AULL, 322, 116 }, { 0xF209787BB47D6B85ULL, 348, 124 },
+	{ 0xB454E4A179DD1877ULL, 375, 132 }, { 0x865B86925B9BC5C2ULL, 402, 140 },
+	{ 0xC83553C5C8965D3DULL, 428, 148 }, { 0x952AB45CFA97A0B3ULL, 455, 156 },
+	{ 0xDE469FBD99A05FE3ULL, 481, 164 }, { 0xA59BC234DB398C25ULL, 508, 172 },
+	{ 0xF6C69A72A3989F5CULL, 534, 180 }, { 0xB7DCBF5354E9BECEULL, 561, 188 },
+	{ 0x88FCF317F22241E2ULL, 588, 196 }, { 0xCC20CE9BD35C78A5ULL, 614, 204 },
+	{ 0x98165AF37B2153DFULL, 641, 212 }, { 0xE2A0B5DC971F303AULL, 667, 220 },
+	{ 0xA8D9D1535CE3B396ULL, 694, 228 }, { 0xFB9B7CD9A4A7443CULL, 720, 236 },
+	{ 0xBB764C4CA7A44410ULL, 747, 244 }, { 0x8BAB8EEFB6409C1AULL, 774, 252 },
+	{ 0xD01FEF10A657842CULL, 800, 260 }, { 0x9B10A4E5E9913129ULL, 827, 268 },
+	{ 0xE7109BFBA19C0C9DULL, 853, 276 }, { 0xAC2820D9623BF429ULL, 880, 284 },
+	{ 0x80444B5E7AA7CF85ULL, 907, 292 }, { 0xBF21E44003ACDD2DULL, 933, 300 },
+	{ 0x8E679C2F5E44FF8FULL, 960, 308 }, { 0xD433179D9C8CB841ULL, 986, 316 },
+	{ 0x9E19DB92B4E31BA9ULL, 1013, 324 },
+};
+
+
+static const char jsonez_digit_pairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+
+// writes u at d and returns the end, two digits at a time from the back
+static char *jsonez_format_uint(char *d, uint64_t u) {
+
+	char tmp[20];
+	char *t = tmp + sizeof(tmp);
+	while (u >= 100) {
+		const char *pair = jsonez_digit_pairs + (u % 100) * 2;
+		u /= 100;
+		*--t = pair[1];
+		*--t = pair[0];
+	}
+	if (u >= 10) {
+		*--t = jsonez_digit_pairs[u * 2 + 1];
+		*--t = jsonez_digit_pairs[u * 2];
+	} else {
+		*--t = (char)('0' + u);
+	}
+
+	size_t len = tmp + sizeof(tmp) - t;
+	memcpy(d, t, len);
+	return d + len;
+
+}
+
+
+static char *jsonez_format_int(char *d, int64_t i) {
+
+	if (i < 0) {
+		*d++ = '-';
+		return jsonez_format_uint(d, 0 - (uint64_t)i);
+	}
+	return jsonez_format_uint(d, (uint64_t)i);
+
+}
+
+
+// the high 64 bits of the product, rounded
+static jsonez_diyfp jsonez_diyfp_mul(jsonez_diyfp x, jsonez_diyfp y) {
+
+	uint64_t a = x.f >> 32, b = x.f & 0xFFFFFFFF;
+	uint64_t c = y.f >> 32, d = y.f & 0xFFFFFFFF;
+	uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	uint64_t mid = (bd >> 32) + (ad & 0xFFFFFFFF) + (bc & 0xFFFFFFFF) + (1ull << 31);
+	jsonez_diyfp r = { ac + (ad >> 32) + (bc >> 32) + (mid >> 32), x.e + y.e + 64 };
+	return r;
+
+}
+
+
+static jsonez_diyfp jsonez_diyfp_normalize(jsonez_diyfp x) {
+
+	int lz = jsonez_clz(x.f);
+	x.f <<= lz;
+	x.e -= lz;
+	return x;
+
+}
+
+
+// walks the last digit down while that gets closer to the real value and
+// stays inside the rounding interval
+static void jsonez_grisu2_round(char *buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k) {
+
+	while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+		buf[len - 1]--;
+		rest += ten_k;
+	}
+
+}
+
+
+// v is positive and finite. the digits go in buf and the value is
+// buf * 10^exponent
+static int jsonez_grisu2(char *buf, double v, int *exponent) {
+
+	uint64_t bits;
+	memcpy(&bits, &v, sizeof(bits));
+	uint64_t F = bits & ((1ull << 52) - 1);
+	int E = (int)(bits >> 52);
+
+	// v and the halfway points to its neighbours, the lower one is closer
+	// when v is a power of two
+	jsonez_diyfp w = E ? (jsonez_diyfp){ F | (1ull << 52), E - 1075 } : (jsonez_diyfp){ F, -1074 };
+	jsonez_diyfp plus = jsonez_diyfp_normalize((jsonez_diyfp){ 2 * w.f + 1, w.e - 1 });
+	jsonez_diyfp minus = F == 0 && E > 1 ? (jsonez_diyfp){ 4 * w.f - 1, w.e - 2 } : (jsonez_diyfp){ 2 * w.f - 1, w.e - 1 };
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+	w = jsonez_diyfp_normalize(w);
+
+	// scale by a cached 10^-k so the binary exponent lands in [-60, -32]
+	int f = -60 - plus.e - 1;
+	int k = (f * 78913) / (1 << 18) + (f > 0);
+	const jsonez_cached_power *cached = jsonez_cached_powers + (300 + k + 7) / 8;
+	jsonez_diyfp c = { cached->f, cached->e };
+	w = jsonez_diyfp_mul(w, c);
+	minus = jsonez_diyfp_mul(minus, c);
+	plus = jsonez_diyfp_mul(plus, c);
+	minus.f++;
+	plus.f--;
+	*exponent = -cached->k;
+
+	uint64_t delta = plus.f - minus.f;
+	uint64_t dist = plus.f - w.f;
+	int shift = -plus.e;
+	uint64_t one = 1ull << shift;
+	uint32_t p1 = (uint32_t)(plus.f >> shift);
+	uint64_t p2 = plus.f & (one - 1);
+
+	// integral digits first, as few as the interval allows
+	uint32_t pow10 = 1;
+	int n = 1;
+	while (n < 10 && p1 >= pow10 * 10) {
+		pow10 *= 10;
+		n++;
+	}
+
+	int len = 0;
+	while (n > 0) {
+		buf[len++] = (char)('0' + p1 / pow10);
+		p1 %= pow10;
+		n--;
+		uint64_t rest = ((uint64_t)p1 << shift) + p2;
+		if (rest <= delta) {
+			*exponent += n;
+			jsonez_grisu2_round(buf, len, dist, delta, rest, (uint64_t)pow10 << shift);
+			return len;
+		}
+		pow10 /= 10;
+	}
+
+	// then fractional ones
+	for (;;) {
+		p2 *= 10;
+		buf[len++] = (char)('0' + (p2 >> shift));
+		p2 &= one - 1;
+		delta *= 10;
+		dist *= 10;
+		(*exponent)--;
+		if (p2 <= delta) {
+			break;
+		}
+	}
+	jsonez_grisu2_round(buf, len, dist, delta, p2, one);
+	return len;
+
+}
+
+
+// writes v at d and returns the end. the layout follows javascript, plain
+// up to 21 integral digits and 6 leading fractional zeros, exponents
+// otherwise. json has no infinity or nan, those become null.
+static char *jsonez_format_double(char *d, double v) {
+
+	if (v != v || v - v != 0) {
+		memcpy(d, "null", 4);
+		return d + 4;
+	}
+	if (v < 0 || (v == 0 && 1 / v < 0)) {
+		*d++ = '-';
+		v = -v;
+	}
+	if (v == 0) {
+		*d++ = '0';
+		return d;
+	}
+	if (v < 9007199254740992.0 && v == (double)(uint64_t)v) {
+		return jsonez_format_uint(d, (uint64_t)v);
+	}
+
+	char digits[20];
+	int exponent;
+	int k = jsonez_grisu2(digits, v, &exponent);
+	int n = k + exponent; // the decimal point goes after this many digits
+
+	if (k <= n && n <= 21) {
+		// digits000
+		memcpy(d, digits, k);
+		memset(d + k, '0', n - k);
+		return d + n;
+	}
+	if (0 < n && n <= 21) {
+		// dig.its
+		memcpy(d, digits, n);
+		d[n] = '.';
+		memcpy(d + n + 1, digits + n, k - n);
+		return d + k + 1;
+	}
+	if (-6 < n && n <= 0) {
+		// 0.000digits
+		d[0] = '0';
+		d[1] = '.';
+		memset(d + 2, '0', -n);
+		memcpy(d + 2 - n, digits, k);
+		return d + 2 - n + k;
+	}
+
+	// d.igitse+12
+	*d++ = digits[0];
+	if (k > 1) {
+		*d++ = '.';
+		memcpy(d, digits + 1, k - 1);
+		d += k - 1;
+	}
+	*d++ = 'e';
+	*d++ = n - 1 < 0 ? '-' : '+';
+	return jsonez_format_uint(d, n - 1 < 0 ? 1 - n : n - 1);
+
+}
+
+
+// any number node, with the exact integer when there is one
+static char *jsonez_format_number(char *d, jsonez *json) {
+
+	if (json->flags & JSONEZ_NODE_INT) {
+		return jsonez_format_int(d, json->i64);
+	}
+	if (json->flags & JSONEZ_NODE_UINT) {
+		return jsonez_format_uint(d, json->u64);
+	}
+	return jsonez_format_double(d, json->n);
+
+}
+
+
+// nodes that were never given a type print as nothing
+static void jsonez_print_error(jsonez *obj) {
+#ifdef JSON_REPORT_ERROR
+	JSON_REPORT_ERROR("Node without a type", obj->key ? obj->key : "(no key)");
+#endif
+}
+
+
+static void jsonez_print_number(jsonez_output *out, jsonez *obj) {
+	char buf[JSONEZ_NUMBER_MAX];
+	jsonez_out_write(out, buf, jsonez_format_number(buf, obj) - buf);
+}
+
+
+static void jsonez_print_string(jsonez_output *out, const char *s) {
+	jsonez_out_char(out, '"');
+	if (s) jsonez_out_string(out, s);
+	jsonez_out_char(out, '"');
+}
+
+
+static void jsonez_print_bool(jsonez_output *out, jsonez *obj) {
+	if (obj->i) jsonez_out_write(out, "true", 4);
+	else jsonez_out_write(out, "false", 5);
+}
+
+
+static void jsonez_print_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
+	if(obj) {
+		switch(obj->type) {
+			case JSON_NUMBER: {
+				jsonez_write_key_value(out, space, obj, ctx);
+				jsonez_print_number(out, obj);
+		   } break;
+			case JSON_STRING:{
+				jsonez_write_key_value(out, space, obj, ctx);
+				jsonez_print_string(out, obj->s);
+			} break;
+			case JSON_BOOL: {
+				jsonez_write_key_value(out, space, obj, ctx);
+				jsonez_print_bool(out, obj);
+			} break;
+			case JSON_ARRAY: {
+				jsonez_write_key_value(out, space, obj, ctx);
+				jsonez_print_array_values(out, space, obj, ctx);
+		   } break;
+			case JSON_OBJ: {
+				jsonez_write_key_value(out, space, obj, ctx);
+			  	jsonez_print_object_values(out, space, obj, ctx);
+		   } break;
+			default: jsonez_print_error(obj); return;
+		}
+	}
+}
+
+
+static void jsonez_print_value(jsonez_output *out, int space, jsonez *value, jsonez_ctx *ctx) {
+	if(value) {
+		switch(value->type) {
+			case JSON_NUMBER: jsonez_print_number(out, value); break;
+			case JSON_STRING: jsonez_print_string(out, value->s); break;
+			case JSON_BOOL: jsonez_print_bool(out, value); break;
+			case JSON_ARRAY: jsonez_print_array_values(out, space, value, ctx); break;
+			case JSON_OBJ: jsonez_print_object_values(out, space, value, ctx); break;
+			default: jsonez_print_error(value); return;
+		}
+	}
+}
+
+
+static void jsonez_root_to_string(jsonez_output *out, jsonez *root, jsonez_ctx *ctx) {
+	jsonez *start = root->child;
+	if (ctx->add_root_object) jsonez_out_write(out, "{\n", 2);
+	if (start) {
+		int indent = ctx->add_root_object ? ctx->indent_length : 0;
+		jsonez_print_key_value(out, indent, start, ctx);
+		while(start->next) {
+			jsonez_out_write(out, ",\n", 2);
+			start = start->next;
+			jsonez_print_key_value(out, indent, start, ctx);
+		}
+	}
+	if (ctx->add_root_object) jsonez_out_write(out, "\n}\n", 3);
+	else jsonez_out_char(out, '\n');
+}
+
+
+
+static jsonez_ctx *jsonez_default_ctx(jsonez_ctx *ctx, jsonez_ctx *defaults) {
+
+	if (ctx == NULL) {
+		defaults->indent_length = 3;
+		defaults->add_root_object = true;
+		defaults->quote_keys = true;
+		defaults->use_equal_sign = false;
+		ctx = defaults;
+	}
+	return ctx;
+
+}
+
+
+JSONEZDEF char *jsonez_to_string(jsonez *root, jsonez_ctx *ctx) {
+
+	jsonez_ctx default_ctx;
+	ctx = jsonez_default_ctx(ctx, &default_ctx);
+
+	jsonez_output out;
+	memset(&out, 0, sizeof(out));
+	out.grow = true;
+
+	jsonez_root_to_string(&out, root, ctx);
+	jsonez_out_char(&out, '\0');
+	if (out.failed) {
+		free(out.buf);
+		return NULL;
+	}
+	return out.buf;
+
+}
+
+
+JSONEZDEF bool jsonez_to_buffer(jsonez *root, jsonez_ctx *ctx, char *buf, size_t cap, size_t *needed) {
+
+	jsonez_ctx default_ctx;
+	ctx = jsonez_default_ctx(ctx, &default_ctx);
+
+	jsonez_output out;
+	memset(&out, 0, sizeof(out));
+	out.buf = buf;
+	out.cap = cap;
+
+	jsonez_root_to_string(&out, root, ctx);
+	jsonez_out_char(&out, '\0');
+	if (needed) {
+		*needed = out.len;
+	}
+	if (out.len > cap) {
+		if (cap) {
+			buf[cap - 1] = '\0';
+		}
+		return false;
+	}
+	return true;
+
+}
+
+
+JSONEZDEF bool jsonez_write(jsonez *root, jsonez_ctx *ctx, jsonez_sink *sink) {
+
+	jsonez_ctx default_ctx;
+	ctx = jsonez_default_ctx(ctx, &default_ctx);
+
+	char staging[JSONEZ_WRITE_CHUNK];
+	jsonez_output out;
+	memset(&out, 0, sizeof(out));
+	out.buf = staging;
+	out.cap = sizeof(staging);
+	out.sink = sink;
+
+	jsonez_root_to_string(&out, root, ctx);
+	return jsonez_out_flush(&out);
+
+}
+
+
+static bool jsonez_file_write(void *user, const char *data, size_t len) {
+
+	return fwrite(data, 1, len, (FILE *)user) == len;
+
+}
+
+
+static bool jsonez_fd_write(void *user, const char *data, size_t len) {
+
+	int fd = (int)(intptr_t)user;
+	while (len) {
+#ifdef _WIN32
+		int chunk = len > 0x40000000 ? 0x40000000 : (int)len;
+		int written = _write(fd, data, chunk);
+#else
+		ssize_t written = write(fd, data, len);
+#endif
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return false;
+		}
+		data += written;
+		len -= written;
+	}
+	return true;
+
+}
+
+
+JSONEZDEF jsonez_sink jsonez_file_sink(FILE *file) {
+
+	jsonez_sink sink = { jsonez_file_write, file };
+	return sink;
+
+}
+
+
+JSONEZDEF jsonez_sink jsonez_fd_sink(int fd) {
+
+	jsonez_sink sink = { jsonez_fd_write, (void *)(intptr_t)fd };
+	return sink;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Tapes
+//
+// a tape is filled in from the event parser, which takes the same grammar
+// as the tree parser. every walk over one keeps the open containers on a heap
+// stack and counts their children down instead of recursing.
+
+
+typedef struct jsonez_tape_frame {
+	size_t node;
+	size_t last; // newest child, while building
+	size_t left; // children still to come, while walking
+	int space;
+	jsonez *tree;
+} jsonez_tape_frame;
+
+
+typedef struct jsonez_tape_stack {
+	jsonez_tape_frame *at;
+	size_t depth;
+	size_t size;
+} jsonez_tape_stack;
+
+
+typedef struct jsonez_tape_builder {
+	jsonez_tape *tape;
+	jsonez_parser *ps; // has the number behind each number event
+	jsonez_tape_stack stack;
+	unsigned int key;
+	unsigned int key_len;
+	unsigned int key_hash;
+	bool failed;
+} jsonez_tape_builder;
+
+
+static jsonez_tape_frame *jsonez_tape_push(jsonez_tape_stack *stack, size_t node) {
+
+	if (stack->depth == stack->size) {
+		size_t size = stack->size ? stack->size * 2 : 32;
+		jsonez_tape_frame *at = (jsonez_tape_frame *)realloc(stack->at, size * sizeof(jsonez_tape_frame));
+		if (!at) {
+			return NULL;
+		}
+		stack->at = at;
+		stack->size = size;
+	}
+	jsonez_tape_frame *frame = &stack->at[stack->depth++];
+	memset(frame, 0, sizeof(jsonez_tape_frame));
+	frame->node = node;
+	return frame;
+
+}
+
+
+// copies s into text with a terminator and returns where it went
+static unsigned int jsonez_tape_text(jsonez_tape_builder *b, const char *s, size_t len) {
+
+	jsonez_tape *tape = b->tape;
+	size_t need = tape->text_len + len + 1;
+	if (need > UINT32_MAX) {
+		b->failed = true;
+		return 0;
+	}
+	if (need > tape->text_size) {
+		size_t size = tape->text_size * 2;
+		while (size < need) {
+			size *= 2;
+		}
+		char *text = (char *)realloc(tape->text, size);
+		if (!text) {
+			b->failed = true;
+			return 0;
+		}
+		tape->text = text;
+		tape->text_size = size;
+	}
+
+	size_t at = tape->text_len;
+	memcpy(tape->text + at, s, len);
+	tape->text[at + len] = '\0';
+	tape->text_len = need;
+	return (unsigned int)at;
+
+}
+
+
+// appends a node and links it under the open container
+static jsonez_tape_node *jsonez_tape_add(jsonez_tape_builder *b, jsonez_type type) {
+
+	jsonez_tape *tape = b->tape;
+	if (b->failed) {
+		return NULL;
+	}
+	if (tape->count == tape->nodes_size) {
+		size_t size = tape->nodes_size * 2;
+		jsonez_tape_node *nodes = size <= UINT32_MAX ? (jsonez_tape_node *)realloc(tape->nodes, size * sizeof(jsonez_tape_node)) : NULL;
+		if (!nodes) {
+			b->failed = true;
+			return NULL;
+		}
+		tape->nodes = nodes;
+		tape->nodes_size = size;
 	}
 
-	obj->s = (char *)calloc(size + 1, sizeof(char));
-	p = value;
-	char *dest = obj->s;
-	while (p && *p) {
-		switch(*p) {
-			case '"':
-			case '\\':
-			case '\b':
-			case '\f':
-			case '\n':
-			case '\r':
-			case '\t':
-				*dest++ = '\\';
-				break;
-		}	
-		*dest++ = *p++;
+	size_t index = tape->count++;
+	jsonez_tape_node *node = &tape->nodes[index];
+	memset(node, 0, sizeof(jsonez_tape_node));
+	node->type = (unsigned char)type;
+
+	if (b->stack.depth) {
+		jsonez_tape_frame *top = &b->stack.at[b->stack.depth - 1];
+		jsonez_tape_node *parent = &tape->nodes[top->node];
+		if (parent->type == JSON_OBJ) {
+			node->key = b->key;
+			node->key_len = b->key_len;
+			node->key_hash = b->key_hash;
+		}
+		if (top->last) {
+			tape->nodes[top->last].next = (unsigned int)index;
+		}
+		top->last = index;
+		parent->count++;
 	}
+	return node;
 
-	obj->s[size] = '\0';
-	return obj;
+}
+
+
+static bool jsonez_tape_begin(jsonez_tape_builder *b, jsonez_type type) {
+
+	jsonez_tape_node *node = jsonez_tape_add(b, type);
+	if (!node || !jsonez_tape_push(&b->stack, node - b->tape->nodes)) {
+		b->failed = true;
+		return false;
+	}
+	return true;
 
 }
 
 
-static void jsonez_print_array_values(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
+static bool jsonez_tape_begin_object(void *user) {
 
-	JSONEZ_WRITE_STRING(out, " [");
-	jsonez *arr_obj = obj->child;
-	if (arr_obj) {
-		jsonez_print_value(out, space, arr_obj, ctx);
-		while(arr_obj->next) {
-			arr_obj = arr_obj->next;
-			JSONEZ_WRITE_STRING(out, ", ");
-			jsonez_print_value(out, space, arr_obj, ctx);
-		}
+	return jsonez_tape_begin((jsonez_tape_builder *)user, JSON_OBJ);
+
+}
+
+
+static bool jsonez_tape_begin_array(void *user) {
+
+	return jsonez_tape_begin((jsonez_tape_builder *)user, JSON_ARRAY);
+
+}
+
+
+static bool jsonez_tape_end(void *user) {
+
+	jsonez_tape_builder *b = (jsonez_tape_builder *)user;
+	if (b->stack.depth) {
+		b->stack.depth--;
 	}
-	JSONEZ_WRITE_STRING(out, "]");
+	return true;
+
 }
 
 
-static void jsonez_print_object_values(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
-	JSONEZ_WRITE_STRING(out, "{\n");
-	if (obj) {
-		jsonez *child = obj->child;
-		if (child) {
-			jsonez_print_key_value(out, space + ctx->indent_length, child, ctx);
-			while(child->next) {
-				JSONEZ_WRITE_STRING(out, ",\n");
-				child = child->next;
-				jsonez_print_key_value(out, space + ctx->indent_length, child, ctx);
-			}
-		}
+static bool jsonez_tape_key_event(void *user, const char *s, size_t len) {
+
+	jsonez_tape_builder *b = (jsonez_tape_builder *)user;
+	if (!s) {
+		// no key at all, like the tree's null one
+		b->key = b->key_len = b->key_hash = 0;
+		return true;
 	}
-	JSONEZ_WRITE_STRING(out, "\n%*s}", space, "");
+	b->key = jsonez_tape_text(b, s, len);
+	b->key_len = (unsigned int)len;
+	b->key_hash = jsonez_hash(s, len);
+	return !b->failed;
+
 }
 
 
-static bool jsonez_is_key_raw(char *key) {
-	while(key && *key) {
-		if (!JSONEZ_RAW_KEY(*key)) {
-			return false;
-		}
-		key++;
+static bool jsonez_tape_string_event(void *user, const char *s, size_t len) {
+
+	jsonez_tape_builder *b = (jsonez_tape_builder *)user;
+	unsigned int at = jsonez_tape_text(b, s, len);
+	jsonez_tape_node *node = jsonez_tape_add(b, JSON_STRING);
+	if (!node) {
+		return false;
 	}
+	node->s = at;
+	node->count = (unsigned int)len;
 	return true;
+
 }
 
 
-static void jsonez_write_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
-	const char *separator = ctx->use_equal_sign ? " = " : ": ";
-	if (ctx->quote_keys || !jsonez_is_key_raw(obj->key)) {
-		JSONEZ_WRITE_STRING(out, "%*s\"%s\"%s", space, "", obj->key, separator);
-	} else {
-		JSONEZ_WRITE_STRING(out, "%*s%s%s", space, "", obj->key, separator);
+static bool jsonez_tape_number_event(void *user, double value, const char *text, size_t len) {
+
+	jsonez_tape_builder *b = (jsonez_tape_builder *)user;
+	jsonez_tape_node *node = jsonez_tape_add(b, JSON_NUMBER);
+	if (!node) {
+		return false;
 	}
+	node->n = value;
+
+	// text was scanned into the parser's number already, the exact
+	// integer is there
+	(void)text;
+	(void)len;
+	jsonez *num = &b->ps->number;
+	if (num->flags & (JSONEZ_NODE_INT | JSONEZ_NODE_UINT)) {
+		node->flags = (unsigned char)num->flags;
+		node->u64 = num->u64;
+	}
+	return true;
+
 }
 
 
+static bool jsonez_tape_bool_event(void *user, bool value) {
+
+	jsonez_tape_node *node = jsonez_tape_add((jsonez_tape_builder *)user, JSON_BOOL);
+	if (!node) {
+		return false;
+	}
+	node->b = value;
+	return true;
 
-//@TODO: something better than this
-static void jsonez_print_error(jsonez *obj) {
-	printf("ERROR!!!\n");
 }
 
 
-static void jsonez_print_key_value(jsonez_output *out, int space, jsonez *obj, jsonez_ctx *ctx) {
-	if(obj) {
-		switch(obj->type) {
-			case JSON_NUMBER: {
-				jsonez_write_key_value(out, space, obj, ctx);
-				JSONEZ_WRITE_STRING(out, "%f", obj->n); 
-		   } break;
-			case JSON_STRING:{
-				jsonez_write_key_value(out, space, obj, ctx);
-		   	JSONEZ_WRITE_STRING(out, "\"%s\"", obj->s);
+static void jsonez_tape_close(jsonez_output *out, jsonez_tape_node *node, int space, jsonez_ctx *ctx) {
+
+	if (node->type == JSON_ARRAY) {
+		jsonez_out_char(out, ']');
+	} else {
+		jsonez_out_char(out, '\n');
+		jsonez_out_indent(out, space - ctx->indent_length);
+		jsonez_out_char(out, '}');
+	}
+
+}
+
+
+// jsonez_root_to_string in one pass over the nodes. a frame's space is
+// what its children are printed with, which objects indent one step more.
+static void jsonez_tape_print(jsonez_output *out, jsonez_tape *tape, jsonez_ctx *ctx) {
+
+	jsonez_tape_stack stack;
+	memset(&stack, 0, sizeof(stack));
+	jsonez_tape_frame *top = jsonez_tape_push(&stack, 0);
+	if (!top) {
+		out->failed = true;
+		return;
+	}
+	top->left = tape->count ? tape->nodes[0].count : 0;
+	top->space = ctx->add_root_object ? ctx->indent_length : 0;
+
+	if (ctx->add_root_object) jsonez_out_write(out, "{\n", 2);
+	for (size_t i = 1; i < tape->count; i++) {
+		jsonez_tape_node *node = &tape->nodes[i];
+		top = &stack.at[stack.depth - 1];
+		jsonez_tape_node *parent = &tape->nodes[top->node];
+		bool item = parent->type == JSON_ARRAY;
+		if (top->left != parent->count) {
+			jsonez_out_write(out, item ? ", " : ",\n", 2);
+		}
+		top->left--;
+		if (!item) {
+			jsonez_write_key(out, top->space, tape->text + node->key, node->key_len, ctx);
+		}
+
+		int space = top->space;
+		switch (node->type) {
+			case JSON_OBJ: {
+				jsonez_out_write(out, "{\n", 2);
+				space += ctx->indent_length;
 			} break;
+			case JSON_ARRAY: jsonez_out_write(out, " [", 2); break;
+			case JSON_STRING: jsonez_print_string(out, tape->text + node->s); break;
 			case JSON_BOOL: {
-				jsonez_write_key_value(out, space, obj, ctx);
-				JSONEZ_WRITE_STRING(out, "%s", obj->i ? "true" : "false"); 
+				if (node->b) jsonez_out_write(out, "true", 4);
+				else jsonez_out_write(out, "false", 5);
 			} break;
-			case JSON_ARRAY: {
-				jsonez_write_key_value(out, space, obj, ctx);
-				jsonez_print_array_values(out, space, obj, ctx);
-		   } break;
-			case JSON_OBJ: {
-				jsonez_write_key_value(out, space, obj, ctx);
-			  	jsonez_print_object_values(out, space, obj, ctx);
-		   } break;
-			default: jsonez_print_error(obj); return;
+			default: {
+				jsonez num;
+				num.flags = node->flags;
+				num.n = node->n;
+				num.u64 = node->u64;
+				jsonez_print_number(out, &num);
+			}
+		}
+
+		if (node->type == JSON_OBJ || node->type == JSON_ARRAY) {
+			if (node->count) {
+				top = jsonez_tape_push(&stack, i);
+				if (!top) {
+					out->failed = true;
+					break;
+				}
+				top->left = node->count;
+				top->space = space;
+				continue;
+			}
+			jsonez_tape_close(out, node, space, ctx);
+		}
+		while (stack.depth > 1 && !stack.at[stack.depth - 1].left) {
+			top = &stack.at[--stack.depth];
+			jsonez_tape_close(out, &tape->nodes[top->node], top->space, ctx);
 		}
 	}
+	if (ctx->add_root_object) jsonez_out_write(out, "\n}\n", 3);
+	else jsonez_out_char(out, '\n');
+	free(stack.at);
+
 }
 
 
-static void jsonez_print_value(jsonez_output *out, int space, jsonez *value, jsonez_ctx *ctx) {
-	if(value) {
-		switch(value->type) {
-			case JSON_NUMBER: JSONEZ_WRITE_STRING(out, "%f", value->n); break;
-			case JSON_STRING: JSONEZ_WRITE_STRING(out, "\"%s\"", value->s); break;
-			case JSON_BOOL: JSONEZ_WRITE_STRING(out, "%s", value->i ? "true" : "false"); break;
-			case JSON_ARRAY: jsonez_print_array_values(out, space, value, ctx); break;
-			case JSON_OBJ: jsonez_print_object_values(out, space, value, ctx); break;
-			default: jsonez_print_error(value); return;
-		}
+JSONEZDEF jsonez_tape *jsonez_tape_parse(const char *data, size_t len) {
+
+	jsonez_tape *tape = (jsonez_tape *)calloc(1, sizeof(jsonez_tape));
+	if (!tape) {
+		return NULL;
+	}
+	tape->nodes_size = 64;
+	tape->nodes = (jsonez_tape_node *)malloc(tape->nodes_size * sizeof(jsonez_tape_node));
+	tape->text_size = 256;
+	tape->text = (char *)malloc(tape->text_size);
+	if (!tape->nodes || !tape->text) {
+		jsonez_tape_free(tape);
+		return NULL;
+	}
+	// offset 0 stays empty so it can mean no key
+	tape->text[0] = '\0';
+	tape->text_len = 1;
+
+	jsonez_parser ps;
+	jsonez_parser_init(&ps, NULL);
+	jsonez_tape_builder b;
+	memset(&b, 0, sizeof(b));
+	b.tape = tape;
+	b.ps = &ps;
+	jsonez_handler handler = {
+		jsonez_tape_begin_object, jsonez_tape_end,
+		jsonez_tape_begin_array, jsonez_tape_end,
+		jsonez_tape_key_event, jsonez_tape_string_event,
+		jsonez_tape_number_event, jsonez_tape_bool_event,
+		&b
+	};
+	ps.sax = &handler;
+	jsonez_parse_events(&ps, data, len);
+	free(b.stack.at);
+
+	if (b.failed) {
+		jsonez_tape_free(tape);
+		return NULL;
 	}
+	return tape;
+
 }
 
 
-static void jsonez_root_to_string(jsonez_output *out, jsonez *root, jsonez_ctx *ctx) {
-	jsonez *start = root->child;
-	if (ctx->add_root_object) JSONEZ_WRITE_STRING(out, "{\n");
-	if (start) {
-		int indent = ctx->add_root_object ? ctx->indent_length : 0;
-		jsonez_print_key_value(out, indent, start, ctx);
-		while(start->next) {
-			JSONEZ_WRITE_STRING(out, ",\n");
-			start = start->next;
-			jsonez_print_key_value(out, indent, start, ctx);
+JSONEZDEF void jsonez_tape_free(jsonez_tape *tape) {
+
+	if (tape) {
+		free(tape->nodes);
+		free(tape->text);
+		free(tape);
+	}
+
+}
+
+
+JSONEZDEF size_t jsonez_tape_find(jsonez_tape *tape, size_t parent, const char *key) {
+
+	if (tape == NULL || key == NULL || parent >= tape->count || tape->nodes[parent].type != JSON_OBJ)
+		return 0;
+
+	size_t len = strlen(key);
+	unsigned int hash = jsonez_hash(key, len);
+	for (size_t i = jsonez_tape_child(tape, parent); i; i = tape->nodes[i].next) {
+		jsonez_tape_node *node = &tape->nodes[i];
+		if (node->key_hash == hash && node->key_len == len && !memcmp(tape->text + node->key, key, len)) {
+			return i;
 		}
 	}
-	if (ctx->add_root_object) JSONEZ_WRITE_STRING(out, "\n}\n");
-	else JSONEZ_WRITE_STRING(out, "\n");
+	return 0;
+
 }
 
 
+JSONEZDEF size_t jsonez_tape_child(jsonez_tape *tape, size_t node) {
 
-JSONEZDEF char *jsonez_to_string(jsonez *root, jsonez_ctx *ctx) {
+	if (tape == NULL || node >= tape->count)
+		return 0;
 
-	jsonez_ctx default_ctx;
-	if (ctx == NULL) {
-		default_ctx.indent_length = 3;
-		default_ctx.add_root_object = true;
-		default_ctx.quote_keys = true;
-		default_ctx.use_equal_sign = false;
-		ctx = &default_ctx;
+	// children follow their container directly
+	jsonez_tape_node *parent = &tape->nodes[node];
+	if ((parent->type == JSON_OBJ || parent->type == JSON_ARRAY) && parent->count) {
+		return node + 1;
+	}
+	return 0;
+
+}
+
+
+JSONEZDEF size_t jsonez_tape_next(jsonez_tape *tape, size_t node) {
+
+	if (tape == NULL || node >= tape->count)
+		return 0;
+	return tape->nodes[node].next;
+
+}
+
+
+JSONEZDEF const char *jsonez_tape_key(jsonez_tape *tape, size_t node) {
+
+	if (tape == NULL || node >= tape->count || !tape->nodes[node].key)
+		return NULL;
+	return tape->text + tape->nodes[node].key;
+
+}
+
+
+JSONEZDEF const char *jsonez_tape_string(jsonez_tape *tape, size_t node) {
+
+	if (tape == NULL || node >= tape->count || tape->nodes[node].type != JSON_STRING)
+		return NULL;
+	return tape->text + tape->nodes[node].s;
+
+}
+
+
+JSONEZDEF jsonez *jsonez_tape_to_tree(jsonez_tape *tape) {
+
+	jsonez *root = jsonez_create_root();
+	if (root == NULL || tape == NULL || !tape->count) {
+		return root;
+	}
+
+	jsonez_tape_stack stack;
+	memset(&stack, 0, sizeof(stack));
+	jsonez_tape_frame *top = jsonez_tape_push(&stack, 0);
+	if (!top) {
+		jsonez_free(root);
+		return NULL;
+	}
+	top->left = tape->nodes[0].count;
+	top->tree = root;
+
+	for (size_t i = 1; i < tape->count && stack.depth; i++) {
+		jsonez_tape_node *node = &tape->nodes[i];
+		top = &stack.at[stack.depth - 1];
+		char *key = node->key ? tape->text + node->key : NULL;
+		jsonez *json;
+		switch (node->type) {
+			case JSON_OBJ: json = jsonez_create_object(top->tree, key); break;
+			case JSON_ARRAY: json = jsonez_create_array(top->tree, key); break;
+			case JSON_STRING: {
+				// the tape holds the decoded text like a parsed tree does,
+				// jsonez_create_string would escape it again
+				json = jsonez_create(NULL, top->tree, key);
+				if (json) {
+					json->type = JSON_STRING;
+					json->s = jsonez_strdup(NULL, tape->text + node->s);
+					json = json->s ? json : NULL;
+				}
+			} break;
+			case JSON_BOOL: json = jsonez_create_bool(top->tree, key, node->b); break;
+			default: {
+				if (node->flags & JSONEZ_NODE_INT) json = jsonez_create_int64(top->tree, key, node->i64);
+				else if (node->flags & JSONEZ_NODE_UINT) json = jsonez_create_uint64(top->tree, key, node->u64);
+				else json = jsonez_create_numd(top->tree, key, node->n);
+			}
+		}
+		top->left--;
+
+		if (json && (node->type == JSON_OBJ || node->type == JSON_ARRAY) && node->count) {
+			top = jsonez_tape_push(&stack, i);
+			if (top) {
+				top->left = node->count;
+				top->tree = json;
+			}
+		}
+		if (!json || !top) {
+			// out of memory, half a tree would pass for the whole one
+			free(stack.at);
+			jsonez_free(root);
+			return NULL;
+		}
+		while (stack.depth && !stack.at[stack.depth - 1].left) {
+			stack.depth--;
+		}
 	}
+	free(stack.at);
+	return root;
+
+}
+
+
+JSONEZDEF char *jsonez_tape_to_string(jsonez_tape *tape, jsonez_ctx *ctx) {
+
+	jsonez_ctx default_ctx;
+	ctx = jsonez_default_ctx(ctx, &default_ctx);
 
 	jsonez_output out;
-	out.total = 0;
-	out.ptr = NULL;
-	out.remaining = 0;
+	memset(&out, 0, sizeof(out));
+	out.grow = true;
 
-	jsonez_root_to_string(&out, root, ctx);
-	char *string = (char *)calloc(out.total + 1, sizeof(char));
+	jsonez_tape_print(&out, tape, ctx);
+	jsonez_out_char(&out, '\0');
+	if (out.failed) {
+		free(out.buf);
+		return NULL;
+	}
+	return out.buf;
 
-	out.remaining = out.total;
-	out.total = 0;
-	out.ptr = string;
-	jsonez_root_to_string(&out, root, ctx);
+}
+
+
+JSONEZDEF bool jsonez_tape_write(jsonez_tape *tape, jsonez_ctx *ctx, jsonez_sink *sink) {
+
+	jsonez_ctx default_ctx;
+	ctx = jsonez_default_ctx(ctx, &default_ctx);
+
+	char staging[JSONEZ_WRITE_CHUNK];
+	jsonez_output out;
+	memset(&out, 0, sizeof(out));
+	out.buf = staging;
+	out.cap = sizeof(staging);
+	out.sink = sink;
 
-	string[out.total] = '\0';
-	return string;
+	jsonez_tape_print(&out, tape, ctx);
+	return jsonez_out_flush(&out);
 
 }
 
@@ -989,6 +7935,87 @@ JSONEZDEF void jsonez_free_string(char *string) {
 }
 
 
+JSONEZDEF jsonez_keypool *jsonez_keypool_create() {
+
+	return jsonez_keypool_new(NULL, 4096);
+
+}
+
+
+JSONEZDEF void jsonez_keypool_destroy(jsonez_keypool *pool) {
+
+	if (pool && pool->owns_arena) {
+		jsonez_arena_destroy(pool->arena);
+		free(pool->slots);
+		free(pool);
+	}
+
+}
+
+
+JSONEZDEF jsonez_arena *jsonez_arena_create(size_t size_hint) {
+
+	jsonez_arena *arena = (jsonez_arena *)calloc(1, sizeof(jsonez_arena));
+	if (!arena) {
+		return NULL;
+	}
+	arena->size_hint = size_hint ? JSONEZ_ARENA_ALIGN(size_hint) : JSONEZ_ARENA_BLOCK_SIZE;
+	return arena;
+
+}
+
+
+JSONEZDEF size_t jsonez_arena_used(jsonez_arena *arena) {
+
+	size_t used = 0;
+	for (jsonez_arena_block *block = arena->head; block; block = block->next) {
+		used += block->used;
+	}
+	return used;
+
+}
+
+
+JSONEZDEF void jsonez_arena_reset(jsonez_arena *arena) {
+
+	size_t used = jsonez_arena_used(arena);
+	if (used > arena->size_hint) {
+		arena->size_hint = JSONEZ_ARENA_ALIGN(used);
+	}
+
+	// one block that fits everything is kept, otherwise the blocks
+	// get swapped for a single one sized by the last parse
+	jsonez_arena_block *block = arena->head;
+	if (block && !block->next && block->size >= arena->size_hint) {
+		block->used = 0;
+		return;
+	}
+
+	while (block) {
+		jsonez_arena_block *next = block->next;
+		free(block);
+		block = next;
+	}
+	arena->head = jsonez_arena_new_block(arena->size_hint);
+
+}
+
+
+JSONEZDEF void jsonez_arena_destroy(jsonez_arena *arena) {
+
+	if (arena) {
+		jsonez_arena_block *block = arena->head;
+		while (block) {
+			jsonez_arena_block *next = block->next;
+			free(block);
+			block = next;
+		}
+		free(arena);
+	}
+
+}
+
+
 #endif // JSONEZ_IMPLEMENTATION
 
 /*
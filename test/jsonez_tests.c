@@ -59,6 +59,11 @@
 
 static int tests_run;
 
+// small chunks so the ndjson, parallel and two stage tests cross a lot of them
+#define JSONEZ_NDJSON_CHUNK 4096
+#define JSONEZ_PARALLEL_MIN 4096
+#define JSONEZ_PARALLEL_CHUNK 256
+#define JSONEZ_STAGE1_WINDOW 256
 #define JSONEZ_IMPLEMENTATION
 #include "../jsonez.h"
 
@@ -77,6 +82,1371 @@ static int tests_run;
 
 
 
+typedef struct test_sax_state {
+	char log[512];
+	size_t len;
+	double sum;
+	int stop_at;
+	int events;
+} test_sax_state;
+
+
+static bool test_sax_log(test_sax_state *state, const char *s, size_t len) {
+	state->len += snprintf(state->log + state->len, sizeof(state->log) - state->len, "%.*s ", (int)len, s);
+	return ++state->events != state->stop_at;
+}
+
+static bool test_sax_begin_object(void *user) { return test_sax_log((test_sax_state *)user, "{", 1); }
+static bool test_sax_end_object(void *user) { return test_sax_log((test_sax_state *)user, "}", 1); }
+static bool test_sax_begin_array(void *user) { return test_sax_log((test_sax_state *)user, "[", 1); }
+static bool test_sax_end_array(void *user) { return test_sax_log((test_sax_state *)user, "]", 1); }
+static bool test_sax_key(void *user, const char *s, size_t len) { return test_sax_log((test_sax_state *)user, s ? s : "~", s ? len : 1); }
+static bool test_sax_string(void *user, const char *s, size_t len) { return test_sax_log((test_sax_state *)user, s, len); }
+static bool test_sax_bool(void *user, bool value) { return test_sax_log((test_sax_state *)user, value ? "T" : "F", 1); }
+static bool test_sax_number(void *user, double value, const char *text, size_t len) {
+	test_sax_state *state = (test_sax_state *)user;
+	state->sum += value;
+	return test_sax_log(state, text, len);
+}
+
+
+typedef struct test_ndjson_state {
+	int ids[4000];
+	bool errors[4000];
+	size_t error_at[4000];
+	size_t next;
+	bool ordered;
+	bool in_order;
+	size_t stop_at;
+} test_ndjson_state;
+
+
+static bool test_ndjson_record(void *user, jsonez_record *record) {
+
+	// unordered calls come from several threads, each only touches its own slot
+	test_ndjson_state *st = (test_ndjson_state *)user;
+	jsonez *id = jsonez_find(record->json, "id");
+	st->ids[record->index] = id ? (int)id->n : -1;
+	st->errors[record->index] = record->error.code != JSONEZ_OK;
+	st->error_at[record->index] = record->error.offset;
+	if (st->ordered) {
+		st->in_order &= record->index == st->next++;
+	}
+	jsonez_free(record->json);
+	return record->index != st->stop_at;
+
+}
+
+
+typedef struct test_error_case {
+	const char *text;
+	jsonez_error_code code;
+	size_t offset;
+} test_error_case;
+
+
+const char *test_validate() {
+
+	// whatever the tree parser says, validating says the same
+	static const char *texts[] = {
+		"{a: 1, b: [1, 2.5e3, -7], \"c\\n\": {d = \"x\\\"y\\u00e9\"}}",
+		"a: 1 // trailing\n",
+		"",
+		"a: 1,\nb: [1, 2}",
+		"{a: 1",
+		"a: 1,\nb: \"abc",
+		"a: \"\\q\"",
+		"a: \"\\u12\"",
+		"a: 1.2.3",
+		"a: 1e400",
+		"a: 1e-400",
+		"a: -",
+		"a: tru",
+		"a: 1 /* x",
+		"a: 1 // x",
+		"{a: [1, {b 2}]}",
+		"{: 1}",
+		"{a:1} junk",
+		"{a:1}}",
+		"{a:1} {b:2}",
+		"{a:1} /* done */",
+	};
+	for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+		const char *text = texts[i];
+		jsonez_error want, err;
+		jsonez_parse_opts opts = { .error = &want };
+		jsonez_free(jsonez_parse_n(text, strlen(text), &opts));
+		memset(&err, 0xff, sizeof(err));
+		bool ok = jsonez_validate(text, strlen(text), &err);
+		mu_assert(ok == (want.code == JSONEZ_OK), "Validate should agree with parse");
+		mu_assert(err.code == want.code && err.offset == want.offset, "Validate should report the same error");
+	}
+	mu_assert(jsonez_validate("a: [1, 2]", 9, NULL), "Should validate without an error");
+	mu_assert(!jsonez_validate("a: [1, 2", 8, NULL), "Should fail without an error");
+	jsonez_error err;
+	mu_assert(!jsonez_validate("{a:1} junk", 10, &err), "Should fail on text after the root");
+	mu_assert(err.code == JSONEZ_ERROR_SYNTAX && err.offset == 6, "Should point at the text after the root");
+
+	return NULL;
+
+}
+
+
+const char *test_parse_errors() {
+
+	static const test_error_case cases[] = {
+		{ "{a: 1, b: [1, 2]}", JSONEZ_OK, 0 },
+		{ "", JSONEZ_OK, 0 },
+		{ "a: 1,\nb: [1, 2}", JSONEZ_ERROR_SYNTAX, 14 },
+		{ "{a: 1", JSONEZ_ERROR_EOF, 5 },
+		{ "a: [1, 2", JSONEZ_ERROR_EOF, 8 },
+		{ "a: 1,\nb: \"abc", JSONEZ_ERROR_STRING, 13 },
+		{ "a: \"\\q\"", JSONEZ_ERROR_STRING, 5 },
+		{ "a: 1.2.3", JSONEZ_ERROR_NUMBER, 3 },
+		{ "a: tru", JSONEZ_ERROR_LITERAL, 3 },
+		{ "a: 1 /* x", JSONEZ_ERROR_COMMENT, 9 },
+		{ "{a: [1, {b 2}]}", JSONEZ_ERROR_KEY, 11 },
+		{ "{a:1} junk", JSONEZ_ERROR_SYNTAX, 6 },
+		{ "{a:1}}", JSONEZ_ERROR_SYNTAX, 5 },
+		{ "{a:1} {b:2}", JSONEZ_ERROR_SYNTAX, 6 },
+		{ "{a:1} // done\n", JSONEZ_OK, 0 },
+	};
+	jsonez_error err;
+	jsonez_parse_opts opts = { .error = &err };
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		const char *text = cases[i].text;
+		memset(&err, 0xff, sizeof(err));
+		jsonez_free(jsonez_parse_n(text, strlen(text), &opts));
+		mu_assert(err.code == cases[i].code, "Wrong error code");
+		mu_assert(err.offset == cases[i].offset, "Wrong error offset");
+		mu_assert(!err.code == !err.message, "Errors should come with a message");
+	}
+
+	size_t line, column;
+	const char *text = cases[2].text;
+	jsonez_free(jsonez_parse_n(text, strlen(text), &opts));
+	jsonez_error_position(text, &err, &line, &column);
+	mu_assert(line == 2 && column == 9, "Wrong line or column");
+
+	// offsets count from the first chunk
+	jsonez_stream *st = jsonez_stream_new(&opts);
+	jsonez_stream_feed(st, "a: 1, b: \"x", 11);
+	jsonez_stream_feed(st, "yz\", c: [1,", 11);
+	jsonez_stream_feed(st, " 2, tru]", 8);
+	jsonez_free(jsonez_stream_finish(st));
+	mu_assert(err.code == JSONEZ_ERROR_LITERAL && err.offset == 26, "Stream error should count every chunk");
+	st = jsonez_stream_new(&opts);
+	jsonez_stream_feed(st, "a: [1, 2", 8);
+	jsonez_free(jsonez_stream_finish(st));
+	mu_assert(err.code == JSONEZ_ERROR_EOF && err.offset == 8, "Stream should end too soon");
+
+	// a broken item in a big array is found by whichever thread parses it
+	int records = 2000;
+	char *big = (char *)malloc(records * 64 + 64);
+	char *d = big;
+	d += sprintf(d, "{records: [\n");
+	for (int i = 0; i < records; i++) {
+		d += sprintf(d, "{id: %d, name: \"rec %d\"%s},\n", i, i, i == 1500 ? ", bad: 1.2.3" : "");
+	}
+	d += sprintf(d, "]}");
+	jsonez_error want;
+	opts.error = &want;
+	jsonez_free(jsonez_parse_n(big, d - big, &opts));
+	opts.flags = JSONEZ_PARSE_PARALLEL;
+	opts.threads = 4;
+	opts.error = &err;
+	jsonez_free(jsonez_parse_n(big, d - big, &opts));
+	mu_assert(want.code == JSONEZ_ERROR_NUMBER && err.code == want.code && err.offset == want.offset, "Parallel error should match");
+	mu_assert(!strncmp(big + err.offset, "1.2.3", 5), "Should point at the number");
+	free(big);
+
+	return NULL;
+
+}
+
+
+const char *test_parallel_array() {
+
+	int records = 2000;
+	char *text = (char *)malloc(records * 128 + 256);
+	char *d = text;
+	d += sprintf(d, "{small: [1, 2, [3]], records: [\n");
+	for (int i = 0; i < records; i++) {
+		if (i % 9 == 0) {
+			// strings that look like they end where they start
+			d += sprintf(d, "{id: %d, s: \": ], {\", t: \"\\\", [\"},\n", i);
+		} else if (i % 7 == 0) {
+			d += sprintf(d, "/* \"quoted\" ] */ [%d, \"}\", [], {}],\n", i);
+		} else if (i % 5 == 0) {
+			d += sprintf(d, "%d, \"x\" // \"]\n,", i);
+		} else {
+			d += sprintf(d, "{\"id\": %d, \"name\": \"rec %d\", list: [1, {a: \"]\\\\\"}], b: true}\n,", i, i);
+		}
+	}
+	d += sprintf(d, "], after: \"done\"}");
+
+	jsonez_parse_opts one = {0};
+	jsonez_parse_opts four = { .flags = JSONEZ_PARSE_PARALLEL | JSONEZ_PARSE_INDEX, .threads = 4 };
+	jsonez *want = jsonez_parse_n(text, d - text, &one);
+	jsonez *got = jsonez_parse_n(text, d - text, &four);
+	char *a = jsonez_to_string(want, NULL);
+	char *b = jsonez_to_string(got, NULL);
+	mu_assert(!strcmp(a, b), "Parallel parse should match");
+	jsonez *arr = jsonez_find(got, "records");
+	mu_assert(jsonez_size(arr) > (size_t)records && arr->items, "Should have every item and a table");
+	mu_assert(jsonez_find(jsonez_at(arr, 1), "id")->n == 1, "Items should be in order");
+	mu_assert(!strcmp(jsonez_find(got, "after")->s, "done"), "Should go on after the array");
+	free(a);
+	free(b);
+	jsonez_free(want);
+	jsonez_free(got);
+
+	// unterminated arrays go the usual way
+	*strstr(text, "], after") = ' ';
+	got = jsonez_parse_n(text, d - text, &four);
+	arr = jsonez_find(got, "records");
+	mu_assert(arr && arr->child, "Should keep what parsed");
+	jsonez_free(got);
+
+	// a doubled comma anywhere, slice boundaries included, fails where it
+	// does on one thread
+	jsonez_error want_error, got_error;
+	one.error = &want_error;
+	four.error = &got_error;
+	for (int at = -1; at < 200; at++) {
+		d = text;
+		d += sprintf(d, "{r: [");
+		for (int i = 0; i < 200; i++) {
+			const char *sep = i == at + 1 ? ",," : i ? "," : "";
+			d += sprintf(d, "%s{\"a\": %d, pad: \"long enough to cross a few slices\"}", sep, i);
+		}
+		d += sprintf(d, "%s]}", at == 199 ? ",," : "");
+		jsonez_free(jsonez_parse_n(text, d - text, &one));
+		jsonez_free(jsonez_parse_n(text, d - text, &four));
+		mu_assert(want_error.code == JSONEZ_ERROR_SYNTAX, "A doubled comma should fail");
+		mu_assert(got_error.code == want_error.code && got_error.offset == want_error.offset, "Parallel errors should match");
+	}
+
+	free(text);
+
+	return NULL;
+
+}
+
+
+const char *test_two_stage() {
+
+	int records = 1000;
+	char *text = (char *)malloc(records * 160 + 256);
+	char *d = text;
+	d += sprintf(d, "/* header */ title = \"two stage\", wide: {");
+	for (int i = 0; i < 40; i++) {
+		d += sprintf(d, "k%d: %d, ", i, i);
+	}
+	d += sprintf(d, "}, records: [\n");
+	for (int i = 0; i < records; i++) {
+		if (i % 9 == 0) {
+			// runs of backslashes, some across a block edge
+			d += sprintf(d, "{id: %d, s: \"%.*s\\\\\\\"\\n\\/\"},\n", i, i % 64, "..............................................................................");
+		} else if (i % 7 == 0) {
+			d += sprintf(d, "/* \"quoted\" ] */ [%d, -0.5e-3, \"}\", [], {},], // \"]\n", i);
+		} else if (i % 5 == 0) {
+			d += sprintf(d, "{\"id\" = %d, big: 18446744073709551615, neg: -9223372036854775808, f: false}\n,", i);
+		} else {
+			d += sprintf(d, "{\"id\": %d, \"name\": \"rec %d\", list: [1, {a: \"]\\\\\"}], b: true},\n", i, i);
+		}
+	}
+	d += sprintf(d, "], after: \"done\" // the end\n");
+
+	jsonez_error want_error, got_error;
+	jsonez_parse_opts one = { .error = &want_error };
+	jsonez_parse_opts two = { .flags = JSONEZ_PARSE_TWO_STAGE | JSONEZ_PARSE_INDEX, .error = &got_error };
+	jsonez *want = jsonez_parse_n(text, d - text, &one);
+	jsonez *got = jsonez_parse_n(text, d - text, &two);
+	char *a = jsonez_to_string(want, NULL);
+	char *b = jsonez_to_string(got, NULL);
+	mu_assert(!strcmp(a, b), "Two stage parse should match");
+	mu_assert(want_error.code == JSONEZ_OK && got_error.code == JSONEZ_OK, "Should parse");
+	mu_assert(jsonez_find(got, "wide")->index, "Wide objects should get a table");
+	mu_assert(jsonez_find(jsonez_at(jsonez_find(got, "records"), 5), "big")->flags & JSONEZ_NODE_UINT, "Should keep big integers");
+	free(b);
+	jsonez_free(got);
+
+	jsonez_arena *arena = jsonez_arena_create(0);
+	two.arena = arena;
+	got = jsonez_parse_n(text, d - text, &two);
+	b = jsonez_to_string(got, NULL);
+	mu_assert(!strcmp(a, b), "Two stage arena parse should match");
+	free(a);
+	free(b);
+	jsonez_free(want);
+	jsonez_arena_destroy(arena);
+	two.arena = NULL;
+
+	// broken input anywhere fails the same way, after a tree was half built
+	// from the index or not
+	static const char *tails[] = {
+		"x: [1, 2}", "x: \"\\q\"", "x: 1.2.3", "x: tru", "x: 1 /* open",
+		"x: 1 // open", "x: \"open", "{x 1}", "x: [1,, 2]", "x: 1} y: 2",
+		"x: [1 2, truefalse, {}]", "{: 1}", "x: 1e400",
+	};
+	for (size_t i = 0; i < sizeof(tails) / sizeof(tails[0]); i++) {
+		for (int at = 0; at < 3; at++) {
+			// at the start, in the middle and at the end of the records
+			char *e = at == 0 ? text : at == 1 ? strstr(text, "records") : strstr(text, "after");
+			size_t len = strlen(tails[i]);
+			char *doc = (char *)malloc((e - text) + len + 1);
+			memcpy(doc, text, e - text);
+			memcpy(doc + (e - text), tails[i], len + 1);
+			size_t n = (e - text) + len;
+			want = jsonez_parse_n(doc, n, &one);
+			got = jsonez_parse_n(doc, n, &two);
+			a = jsonez_to_string(want, NULL);
+			b = jsonez_to_string(got, NULL);
+			mu_assert(!strcmp(a, b), "Two stage should keep what parsed");
+			mu_assert(got_error.code == want_error.code && got_error.offset == want_error.offset, "Two stage errors should match");
+			free(a);
+			free(b);
+			jsonez_free(want);
+			jsonez_free(got);
+			free(doc);
+		}
+	}
+
+	// a NUL ends the input
+	text[(d - text) / 2] = '\0';
+	want = jsonez_parse_n(text, d - text, &one);
+	got = jsonez_parse_n(text, d - text, &two);
+	a = jsonez_to_string(want, NULL);
+	b = jsonez_to_string(got, NULL);
+	mu_assert(!strcmp(a, b) && got_error.code == want_error.code && got_error.offset == want_error.offset, "Two stage should stop at a NUL");
+	free(a);
+	free(b);
+	jsonez_free(want);
+	jsonez_free(got);
+	free(text);
+
+	return NULL;
+
+}
+
+
+const char *test_ndjson() {
+
+	int records = 3000;
+	char *text = (char *)malloc(records * 128);
+	char *d = text;
+	for (int i = 0; i < records; i++) {
+		if (i % 17 == 0) {
+			d += sprintf(d, "{id: %d, oops: }\n", i);
+		} else if (i % 7 == 0) {
+			d += sprintf(d, "{id: %d, text: \"two\nlines\"}\n", i);
+		} else if (i % 11 == 0) {
+			d += sprintf(d, "/* a comment\n over lines */ {id: %d}\r\n", i);
+		} else if (i % 13 == 0) {
+			d += sprintf(d, "\n  \n{id: %d} // trailing\n", i);
+		} else if (i % 19 == 0) {
+			// lines with only comments aren't records either
+			d += sprintf(d, "// a note\n  /* and a\n block */  \n{id: %d}\n", i);
+		} else {
+			d += sprintf(d, "{\"id\": %d, \"name\": \"rec // %d\", list: [1, 2, {a: \"}\\\"\"}]}\n", i, i);
+		}
+	}
+	d--; // the last record has no newline
+
+	static test_ndjson_state st;
+	for (int pass = 0; pass < 3; pass++) {
+		memset(&st, 0, sizeof(st));
+		st.ordered = pass != 2;
+		st.in_order = true;
+		st.stop_at = (size_t)-1;
+		jsonez_ndjson_opts opts = { .threads = pass ? 4 : 1, .unordered = pass == 2 };
+		mu_assert(jsonez_parse_ndjson(text, d - text, &opts, test_ndjson_record, &st), "Should read everything");
+		mu_assert(!st.ordered || (st.in_order && st.next == (size_t)records), "Should deliver every record in order");
+		for (int i = 0; i < records; i++) {
+			mu_assert(st.errors[i] == (i % 17 == 0), "Only broken records have errors");
+			mu_assert(!st.errors[i] || text[st.error_at[i]] == '}', "Error offsets should be in the whole input");
+			mu_assert(st.errors[i] || st.ids[i] == i, "Records should split at the right newlines");
+		}
+	}
+
+	// stopping early
+	memset(&st, 0, sizeof(st));
+	st.ordered = true;
+	st.in_order = true;
+	st.stop_at = 100;
+	jsonez_ndjson_opts opts = { .threads = 4 };
+	mu_assert(!jsonez_parse_ndjson(text, d - text, &opts, test_ndjson_record, &st), "Should say it was stopped");
+	mu_assert(st.next == 101, "Nothing after the stop");
+	free(text);
+
+	return NULL;
+
+}
+
+
+const char *test_array_at() {
+
+	jsonez *root = jsonez_create_root();
+	jsonez *arr = jsonez_create_array(root, (char *)"arr");
+	for (int i = 0; i < 1000; ++i) {
+		jsonez_create_numi(arr, NULL, i);
+	}
+	mu_assert(jsonez_size(arr) == 1000 && jsonez_size(root) == 1, "Wrong sizes");
+	mu_assert(jsonez_size(arr->child) == 0, "Numbers have no size");
+	for (int i = 0; i < 1000; ++i) {
+		mu_assert(jsonez_at(arr, i)->n == i, "Should find every item");
+	}
+	mu_assert(arr->items, "Long array should have a table");
+	mu_assert(!jsonez_at(arr, 1000) && !jsonez_at(root, 0), "Nothing past the end or outside arrays");
+
+	// appends keep the table, other edits rebuild it
+	jsonez *last = jsonez_create_numi(arr, NULL, 1000);
+	mu_assert(arr->items && jsonez_at(arr, 1000) == last, "Should append to the table");
+	jsonez_delete(arr, last);
+	mu_assert(arr->items && !jsonez_at(arr, 1000), "Should pop off the table");
+	jsonez_delete(arr, jsonez_at(arr, 0));
+	jsonez *item = jsonez_create_numi(NULL, NULL, -1);
+	jsonez_insert_before(arr, jsonez_at(arr, 500), item);
+	mu_assert(jsonez_at(arr, 0)->n == 1 && jsonez_at(arr, 500) == item && jsonez_at(arr, 501)->n == 501, "Should follow edits");
+	jsonez_free(root);
+
+	// short arrays are walked from both ends
+	const char *text = "short: [0, 1, 2, 3, 4], long: [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17]";
+	jsonez_parse_opts opts = { .flags = JSONEZ_PARSE_INDEX };
+	jsonez *json = jsonez_parse_n(text, strlen(text), &opts);
+	jsonez *shorter = jsonez_find(json, "short");
+	for (int i = 0; i < 5; ++i) {
+		mu_assert(jsonez_at(shorter, i)->n == i, "Should walk to every item");
+	}
+	mu_assert(!shorter->items && jsonez_find(json, "long")->items, "Only long arrays get tables while parsing");
+	mu_assert(jsonez_at(jsonez_find(json, "long"), 17)->n == 17, "Should find the last item");
+	jsonez_free(json);
+
+	jsonez_arena *arena = jsonez_arena_create(0);
+	json = jsonez_parse_arena(arena, (char *)text);
+	jsonez *longer = jsonez_find(json, "long");
+	mu_assert(longer->items && jsonez_at(longer, 9)->n == 9, "Arena trees get tables up front");
+	jsonez_arena_destroy(arena);
+
+	return NULL;
+
+}
+
+
+const char *test_tape() {
+
+	const char *text =
+		"// tape\n"
+		"name: \"tape\", nums: [1, -2.5, 18446744073709551615, -9007199254740993, 1e3],\n"
+		"nested = { a: [[], {}, [true, { deep: [\"x\\ty\"] }]], b: {}, c: false },\n"
+		"list: [ {id: 1}, {id: 2} ], \"last\": \"end\"";
+	jsonez_tape *tape = jsonez_tape_parse(text, strlen(text));
+	mu_assert(tape && tape->nodes[0].type == JSON_OBJ, "Root is an object");
+
+	size_t name = jsonez_tape_find(tape, 0, "name");
+	mu_assert(name && !strcmp(jsonez_tape_string(tape, name), "tape"), "Should find name");
+	mu_assert(!strcmp(jsonez_tape_key(tape, name), "name"), "Wrong key");
+	mu_assert(!jsonez_tape_find(tape, 0, "missing"), "Shouldn't find missing");
+	size_t nums = jsonez_tape_find(tape, 0, "nums");
+	size_t item = jsonez_tape_child(tape, nums);
+	mu_assert(tape->nodes[nums].count == 5 && !jsonez_tape_key(tape, item), "Items have no keys");
+	item = jsonez_tape_next(tape, jsonez_tape_next(tape, item));
+	mu_assert(tape->nodes[item].flags & JSONEZ_NODE_UINT && tape->nodes[item].u64 == 18446744073709551615ULL, "Should keep big integers exact");
+	item = jsonez_tape_next(tape, item);
+	mu_assert(tape->nodes[item].flags & JSONEZ_NODE_INT && tape->nodes[item].i64 == -9007199254740993LL, "Should keep integers exact");
+	size_t deep = jsonez_tape_find(tape, jsonez_tape_find(tape, 0, "nested"), "a");
+	deep = jsonez_tape_next(tape, jsonez_tape_next(tape, jsonez_tape_child(tape, deep)));
+	deep = jsonez_tape_find(tape, jsonez_tape_next(tape, jsonez_tape_child(tape, deep)), "deep");
+	mu_assert(!strcmp(jsonez_tape_string(tape, jsonez_tape_child(tape, deep)), "x\ty"), "Should unescape");
+	mu_assert(!strcmp(jsonez_tape_string(tape, jsonez_tape_find(tape, 0, "last")), "end"), "Should find last");
+
+	// printing and converting give what the tree gives
+	jsonez_parse_opts opts = {0};
+	jsonez *json = jsonez_parse_n(text, strlen(text), &opts);
+	jsonez *tree = jsonez_tape_to_tree(tape);
+	jsonez_ctx ctx = { .quote_keys = false, .indent_length = 2, .use_equal_sign = true, .add_root_object = false };
+	char *want = jsonez_to_string(json, NULL);
+	char *got = jsonez_tape_to_string(tape, NULL);
+	mu_assert(!strcmp(want, got), "Tape should print like the tree");
+	jsonez_free_string(got);
+	got = jsonez_to_string(tree, NULL);
+	mu_assert(!strcmp(want, got), "Converted tree should print the same");
+	jsonez_free_string(got);
+	jsonez_free_string(want);
+	want = jsonez_to_string(json, &ctx);
+	got = jsonez_tape_to_string(tape, &ctx);
+	mu_assert(!strcmp(want, got), "Tape should follow the ctx");
+	jsonez_free_string(got);
+	jsonez_free_string(want);
+	mu_assert(jsonez_find(tree, "nums")->child->next->next->u64 == 18446744073709551615ULL, "Converted numbers stay exact");
+	jsonez_free(tree);
+	jsonez_free(json);
+	jsonez_tape_free(tape);
+
+	// an item without a key has none on the tape either
+	text = "{: 1, b: {: [2]}}";
+	tape = jsonez_tape_parse(text, strlen(text));
+	json = jsonez_parse_n(text, strlen(text), &opts);
+	mu_assert(tape->nodes[0].count == 2 && !jsonez_tape_key(tape, 1), "Keyless item should have no key");
+	want = jsonez_to_string(json, NULL);
+	got = jsonez_tape_to_string(tape, NULL);
+	mu_assert(!strcmp(want, got), "Keyless items should print like the tree");
+	jsonez_free_string(got);
+	jsonez_free_string(want);
+	jsonez_free(json);
+	jsonez_tape_free(tape);
+
+	// nesting past any call stack
+	size_t depth = 100000;
+	char *buf = (char *)malloc(depth * 2 + 8);
+	char *d = buf + sprintf(buf, "a: ");
+	for (size_t i = 0; i < depth; i++) *d++ = '[';
+	for (size_t i = 0; i < depth; i++) *d++ = ']';
+	tape = jsonez_tape_parse(buf, d - buf);
+	mu_assert(tape && tape->count == depth + 1, "Should parse deep nesting");
+	tree = jsonez_tape_to_tree(tape);
+	mu_assert(jsonez_find(tree, "a")->child->child, "Should convert deep nesting");
+	jsonez_free(tree);
+	jsonez_tape_free(tape);
+	free(buf);
+
+	return NULL;
+
+}
+
+
+const char *test_cursor() {
+
+	const char *text =
+		"// settings\n"
+		"name: \"lazy\", skip: { a: [1, \"]}\", { b: \"\\\"{\" }], /* } ] */ c: {} },\n"
+		"\"esc\\\"key\": true, nums: [1, -2.5, 18446744073709551615, 9007199254740993],\n"
+		"list = [ {id: 1}, {id: 2} {id: 3} ], text: \"a\\tb\", last: false";
+	jsonez_doc *doc = jsonez_doc_open(text, strlen(text));
+	jsonez_cursor root = jsonez_doc_root(doc), field, item;
+	mu_assert(jsonez_cursor_type(&root) == JSON_OBJ, "Root is an object");
+
+	const char *s;
+	size_t len;
+	mu_assert(jsonez_cursor_find_field(&root, "name", &field), "Should find name");
+	mu_assert(jsonez_cursor_get_string(&field, &s, &len) && len == 4 && !memcmp(s, "lazy", 4), "Wrong name");
+	mu_assert(jsonez_cursor_find_field(&root, "last", &field), "Should skip to the end");
+	bool b = true;
+	mu_assert(jsonez_cursor_get_bool(&field, &b) && !b, "Wrong last");
+	mu_assert(jsonez_cursor_find_field(&root, "esc\"key", &field), "Should find escaped keys");
+	mu_assert(jsonez_cursor_get_bool(&field, &b) && b, "Wrong bool");
+	mu_assert(!jsonez_cursor_find_field(&root, "missing", &field), "Shouldn't find missing");
+	mu_assert(jsonez_cursor_find_field(&root, "text", &field), "Should find text");
+	mu_assert(jsonez_cursor_get_string(&field, &s, &len) && len == 3 && !memcmp(s, "a\tb", 3), "Should unescape");
+	mu_assert(!jsonez_cursor_get_double(&field, &(double){0}), "A string is no number");
+
+	// nested lookups inside what other lookups skipped
+	jsonez_cursor skip, inner;
+	mu_assert(jsonez_cursor_find_field(&root, "skip", &skip), "Should find skip");
+	mu_assert(jsonez_cursor_find_field(&skip, "c", &inner) && jsonez_cursor_type(&inner) == JSON_OBJ, "Should get past tricky strings");
+	mu_assert(!jsonez_cursor_child(&inner, &item), "Empty object has no children");
+	mu_assert(jsonez_cursor_find_field(&skip, "a", &inner) && jsonez_cursor_child(&inner, &item), "Should get the array");
+	mu_assert(jsonez_cursor_next(&item) && jsonez_cursor_get_string(&item, &s, &len) && len == 2, "Wrong string item");
+	mu_assert(jsonez_cursor_next(&item) && jsonez_cursor_find_field(&item, "b", &field), "Should find b");
+	mu_assert(jsonez_cursor_get_string(&field, &s, &len) && len == 2 && !memcmp(s, "\"{", 2), "Wrong b");
+	mu_assert(!jsonez_cursor_next(&item), "Array should end");
+
+	// numbers keep their exact integers
+	mu_assert(jsonez_cursor_find_field(&root, "nums", &field) && jsonez_cursor_child(&field, &item), "Should get nums");
+	int64_t i;
+	uint64_t u;
+	double d;
+	mu_assert(jsonez_cursor_get_int64(&item, &i) && i == 1, "Wrong 1");
+	mu_assert(jsonez_cursor_next(&item) && jsonez_cursor_get_double(&item, &d) && d == -2.5, "Wrong -2.5");
+	mu_assert(!jsonez_cursor_get_int64(&item, &i), "-2.5 is no integer");
+	mu_assert(jsonez_cursor_next(&item) && jsonez_cursor_get_uint64(&item, &u) && u == UINT64_MAX, "Wrong uint64");
+	mu_assert(jsonez_cursor_next(&item) && jsonez_cursor_get_int64(&item, &i) && i == 9007199254740993LL, "Wrong int64");
+
+	// walking keys, items without commas
+	int ids = 0;
+	mu_assert(jsonez_cursor_find_field(&root, "list", &field) && jsonez_cursor_child(&field, &item), "Should get list");
+	do {
+		jsonez_cursor id;
+		mu_assert(jsonez_cursor_find_field(&item, "id", &id) && jsonez_cursor_get_int64(&id, &i), "Should have an id");
+		ids += (int)i;
+	} while (jsonez_cursor_next(&item));
+	mu_assert(ids == 6, "Wrong ids");
+	int keys = 0;
+	mu_assert(jsonez_cursor_child(&root, &item), "Root has children");
+	do {
+		mu_assert(jsonez_cursor_key(&item, &s, &len), "Members have keys");
+		keys++;
+	} while (jsonez_cursor_next(&item));
+	mu_assert(keys == 7, "Wrong member count");
+	jsonez_doc_close(doc);
+
+	// braces around the root work the same, broken text just stops
+	text = "{ a: { x: [ } , b: 1 ";
+	doc = jsonez_doc_open(text, strlen(text));
+	root = jsonez_doc_root(doc);
+	mu_assert(jsonez_cursor_find_field(&root, "a", &field), "Should find a");
+	mu_assert(!jsonez_cursor_find_field(&root, "b", &field), "Can't get past a broken value");
+	jsonez_doc_close(doc);
+
+	return NULL;
+
+}
+
+
+const char *test_sax() {
+
+	test_sax_state state = {0};
+	jsonez_handler handler = {
+		test_sax_begin_object, test_sax_end_object,
+		test_sax_begin_array, test_sax_end_array,
+		test_sax_key, test_sax_string, test_sax_number, test_sax_bool,
+		&state,
+	};
+	const char *text = "a: 1, \"b\\tc\": [2.5, true, \"x\\ny\", {}], d = { e: false } // done\n";
+	mu_assert(jsonez_parse_sax(text, strlen(text), &handler, NULL), "Should parse");
+	mu_assert(!strcmp(state.log, "{ a 1 b\tc [ 2.5 T x\ny { } ] d { e F } } "), "Wrong events");
+	mu_assert(state.sum == 3.5, "Wrong sum");
+
+	// braces give the same events
+	memset(&state, 0, sizeof(state));
+	text = "{ a: [1, 2] }";
+	mu_assert(jsonez_parse_sax(text, strlen(text), &handler, NULL), "Should parse");
+	mu_assert(!strcmp(state.log, "{ a [ 1 2 ] } "), "Wrong braced events");
+
+	// a callback stops it, callbacks can be left out
+	memset(&state, 0, sizeof(state));
+	state.stop_at = 3;
+	jsonez_error err;
+	mu_assert(!jsonez_parse_sax(text, strlen(text), &handler, &err), "Should stop");
+	mu_assert(state.events == 3, "Should stop right there");
+	mu_assert(err.code == JSONEZ_OK, "A stop isn't an error");
+	jsonez_handler numbers = {0};
+	numbers.number = test_sax_number;
+	numbers.user = &state;
+	state.sum = 0;
+	state.stop_at = -1;
+	mu_assert(jsonez_parse_sax(text, strlen(text), &numbers, NULL), "Should parse");
+	mu_assert(state.sum == 3, "Should only see numbers");
+
+	// an item without a key gets a null one, as in the tree
+	memset(&state, 0, sizeof(state));
+	text = "{: 1, b: {: []}}";
+	mu_assert(jsonez_parse_sax(text, strlen(text), &handler, NULL), "Should parse without a key");
+	mu_assert(!strcmp(state.log, "{ ~ 1 b { ~ [ ] } } "), "Wrong keyless events");
+
+	// errors come back as false, with the same error the tree parser gives
+	text = "a: [1, }";
+	mu_assert(!jsonez_parse_sax(text, strlen(text), &numbers, &err), "Should fail");
+	jsonez_error want;
+	jsonez_parse_opts opts = { .error = &want };
+	jsonez_free(jsonez_parse_n(text, strlen(text), &opts));
+	mu_assert(err.code == want.code && err.offset == want.offset, "Should match the tree parser's error");
+	text = "a: 1 /* open";
+	mu_assert(!jsonez_parse_sax(text, strlen(text), &handler, &err), "An open comment should fail");
+	mu_assert(err.code == JSONEZ_ERROR_COMMENT, "Should say it was the comment");
+	mu_assert(jsonez_parse_sax("", 0, &handler, NULL), "Empty is an empty object");
+
+	return NULL;
+
+}
+
+
+const char *test_stream_chunks() {
+
+	// every split point, including inside strings, escapes, numbers,
+	// comments, raw keys and literals, has to give the same tree
+	const char *docs[] = {
+		"{ \"name\": \"caf\\/e \\\"x\\\"\\n\", count: -12.5e3, big: 18446744073709551615,\n"
+		"  // a line comment\n"
+		"  list: [1 2, true, false, \"s\", {a: 1}, [], [[]]], /* multi\n * line */ empty = {},\n"
+		"  long_key_name_here: 12345678901234567890123 }",
+		"a: 1, b = \"two\", c: [3, 4,], d: { e: {} },",
+		"  x: true  ",
+	};
+	jsonez_ctx ctx = { .quote_keys = true, .indent_length = 0 };
+	for (size_t n = 0; n < sizeof(docs) / sizeof(docs[0]); n++) {
+		const char *doc = docs[n];
+		size_t len = strlen(doc);
+		jsonez *want = jsonez_parse_n(doc, len, NULL);
+		char *expect = jsonez_to_string(want, &ctx);
+		for (size_t chunk = 1; chunk <= len; chunk++) {
+			jsonez_stream *stream = jsonez_stream_new(NULL);
+			for (size_t i = 0; i < len; i += chunk) {
+				size_t size = len - i < chunk ? len - i : chunk;
+				mu_assert(jsonez_stream_feed(stream, doc + i, size), "Feeding should work");
+			}
+			jsonez *json = jsonez_stream_finish(stream);
+			char *got = jsonez_to_string(json, &ctx);
+			mu_assert(!strcmp(got, expect), "Stream should build the same tree");
+			jsonez_free_string(got);
+			jsonez_free(json);
+		}
+		jsonez_free_string(expect);
+		jsonez_free(want);
+	}
+
+	// items without keys, comments left open after the root, input with no
+	// value in it and text after the root are taken or refused the same way
+	const char *odd[] = { "{: 1}", ":{}", "{a: [,2]} // open", "{a: 1} /* open", " \n\t ", "// a note\n", "/* only this */ ", "{a:1} junk", "{a:1}}", "{a:1} /* */ {b:2}" };
+	for (size_t n = 0; n < sizeof(odd) / sizeof(odd[0]); n++) {
+		const char *doc = odd[n];
+		size_t len = strlen(doc);
+		jsonez_error want, err;
+		jsonez_parse_opts opts = { .error = &want };
+		jsonez_free(jsonez_parse_n(doc, len, &opts));
+		opts.error = &err;
+		for (size_t chunk = 1; chunk <= len; chunk++) {
+			jsonez_stream *stream = jsonez_stream_new(&opts);
+			for (size_t i = 0; i < len; i += chunk) {
+				jsonez_stream_feed(stream, doc + i, len - i < chunk ? len - i : chunk);
+			}
+			jsonez_free(jsonez_stream_finish(stream));
+			mu_assert(err.code == want.code && err.offset == want.offset, "Stream should take what the parser takes");
+		}
+	}
+
+	// a long string fed a byte at a time, with an arena
+	size_t count = 100000;
+	char *text = (char *)malloc(count * 2 + 16);
+	char *d = text + sprintf(text, "s: \"");
+	for (size_t i = 0; i < count; i++) {
+		*d++ = i % 1000 == 999 ? '\\' : 'a' + i % 26;
+		if (i % 1000 == 999) *d++ = 'n';
+	}
+	*d++ = '"';
+	*d = '\0';
+	jsonez_arena *arena = jsonez_arena_create(0);
+	jsonez_parse_opts opts = { .arena = arena };
+	jsonez_stream *stream = jsonez_stream_new(&opts);
+	for (char *p = text; p < d; p++) {
+		jsonez_stream_feed(stream, p, 1);
+	}
+	jsonez *json = jsonez_stream_finish(stream);
+	jsonez *s = jsonez_find(json, "s");
+	mu_assert(s && s->type == JSON_STRING && strlen(s->s) == count, "Should get the whole string");
+	mu_assert(s->s[999] == '\n' && s->s[1000] == 'm', "Should decode the escapes");
+	jsonez_arena_destroy(arena);
+	free(text);
+
+	// broken input fails the feed, truncated input still gives what was read
+	stream = jsonez_stream_new(NULL);
+	mu_assert(!jsonez_stream_feed(stream, "a: 1, b: ]", 10), "Should fail on a bad value");
+	mu_assert(!jsonez_stream_feed(stream, "c: 2", 4), "Should stay failed");
+	json = jsonez_stream_finish(stream);
+	mu_assert(json->type == JSON_OBJ && jsonez_find(json, "a"), "Should keep what parsed");
+	jsonez_free(json);
+	stream = jsonez_stream_new(NULL);
+	mu_assert(jsonez_stream_feed(stream, "{a: [1, 2", 9), "Should wait for more");
+	json = jsonez_stream_finish(stream);
+	mu_assert(jsonez_find(json, "a") && jsonez_find(json, "a")->i == 2, "Should keep the items");
+	jsonez_free(json);
+
+	return NULL;
+
+}
+
+
+const char *test_deep_and_long() {
+
+	// a million items used to take a million nested calls to free
+	size_t count = 1000000;
+	char *text = (char *)malloc(count * 2 + 16);
+	char *d = text;
+	d += sprintf(d, "list: [");
+	for (size_t i = 0; i < count; i++) {
+		*d++ = '1';
+		*d++ = ',';
+	}
+	d[-1] = ']';
+	*d = '\0';
+	jsonez *json = jsonez_parse(text);
+	mu_assert(json && jsonez_find(json, "list")->i == (int)count, "Should have a million items");
+	jsonez_free(json);
+	free(text);
+
+	// and deep nesting used to take a call per level to parse
+	int depth = 100000;
+	text = (char *)malloc(depth * 8 + 16);
+	d = text;
+	d += sprintf(d, "{");
+	for (int i = 0; i < depth; i++) {
+		d += sprintf(d, i & 1 ? "{" : "a: [");
+	}
+	d += sprintf(d, "x: 1");
+	for (int i = depth - 1; i >= 0; i--) {
+		*d++ = i & 1 ? '}' : ']';
+	}
+	sprintf(d, ", b: 2 }");
+	json = jsonez_parse(text);
+	mu_assert(json && json->i == 2, "Should have two things");
+	mu_assert(jsonez_find(json, "b")->n == 2, "Should get past the nesting");
+	jsonez *inner = jsonez_find(json, "a");
+	for (int i = 0; i < 6; i++) {
+		mu_assert(inner && inner->type == (i & 1 ? JSON_OBJ : JSON_ARRAY), "Wrong nested type");
+		inner = inner->child;
+	}
+	jsonez_free(json);
+	free(text);
+
+	return NULL;
+
+}
+
+
+typedef struct test_sink_state {
+	const char *expect;
+	size_t calls;
+	size_t bytes;
+	size_t fail_after;
+	bool same;
+} test_sink_state;
+
+
+static bool test_sink_write(void *user, const char *data, size_t len) {
+	test_sink_state *state = (test_sink_state *)user;
+	state->calls++;
+	state->same &= state->bytes + len <= strlen(state->expect) && !memcmp(state->expect + state->bytes, data, len);
+	state->bytes += len;
+	return state->calls != state->fail_after;
+}
+
+
+const char *test_write_sink() {
+
+	jsonez *json = jsonez_create_root();
+	char key[32];
+	for (int i = 0; i < 2000; i++) {
+		sprintf(key, "item%d", i);
+		jsonez *item = jsonez_create_object(json, key);
+		jsonez_create_numi(item, (char *)"id", i);
+		jsonez_create_string(item, (char *)"name", (char *)"streamed");
+	}
+	char *str = jsonez_to_string(json, NULL);
+	size_t len = strlen(str);
+
+	// a FILE gets exactly what jsonez_to_string makes
+	FILE *file = tmpfile();
+	mu_assert(file, "Should get a temporary file");
+	jsonez_sink sink = jsonez_file_sink(file);
+	mu_assert(jsonez_write(json, NULL, &sink), "Should write to the file");
+	mu_assert((size_t)ftell(file) == len, "Wrong file size");
+	char *back = (char *)malloc(len + 1);
+	rewind(file);
+	mu_assert(fread(back, 1, len, file) == len && !memcmp(back, str, len), "File should match the string");
+
+	// and so does a raw fd
+	rewind(file);
+	sink = jsonez_fd_sink(fileno(file));
+	mu_assert(jsonez_write(json, NULL, &sink), "Should write to the fd");
+	fclose(file);
+
+	// output arrives in chunks, and a sink that gives up stops the write
+	test_sink_state state = { str, 0, 0, 0, true };
+	sink.write = test_sink_write;
+	sink.user = &state;
+	mu_assert(jsonez_write(json, NULL, &sink), "Should write to the callback");
+	mu_assert(state.bytes == len && state.calls > 1, "Should come in several chunks");
+	mu_assert(state.same, "Chunks should match the string");
+	state.calls = state.bytes = 0;
+	state.fail_after = 2;
+	mu_assert(!jsonez_write(json, NULL, &sink), "Should pass the failure on");
+	mu_assert(state.calls == 2, "Should stop after the failure");
+
+	free(back);
+	jsonez_free_string(str);
+	jsonez_free(json);
+	return NULL;
+
+}
+
+
+const char *test_to_buffer() {
+
+	char text[] = "{ id: 7, name: \"buffer\", tags: [\"a\", \"b\"], deep: { deeper: { deepest: true } } }";
+	jsonez *json = jsonez_parse(text);
+	char *str = jsonez_to_string(json, NULL);
+	mu_assert(str, "Should get a string");
+	size_t len = strlen(str);
+	mu_assert(len && str[len - 1] == '\n', "Should end with the newline");
+
+	// asking with no buffer just measures
+	size_t needed = 0;
+	mu_assert(!jsonez_to_buffer(json, NULL, NULL, 0, &needed), "Nothing fits in nothing");
+	mu_assert(needed == len + 1, "Should need the length and a terminator");
+
+	char buf[512];
+	mu_assert(jsonez_to_buffer(json, NULL, buf, sizeof(buf), &needed), "Should fit");
+	mu_assert(needed == len + 1 && !strcmp(buf, str), "Should match jsonez_to_string");
+
+	// the same buffer again, too small this time
+	mu_assert(!jsonez_to_buffer(json, NULL, buf, 16, &needed), "Should not fit");
+	mu_assert(needed == len + 1 && strlen(buf) == 15 && !strncmp(buf, str, 15), "Should be cut and terminated");
+
+	// deep indentation comes from the same spaces
+	jsonez_ctx ctx = { true, 40, false, true };
+	char *wide = jsonez_to_string(json, &ctx);
+	mu_assert(strstr(wide, "\n                                                                                                                        \"deepest\": true"), "Should indent three levels");
+	jsonez_free_string(wide);
+
+	jsonez_free_string(str);
+	jsonez_free(json);
+	return NULL;
+
+}
+
+
+const char *test_print_numbers() {
+
+	double values[] = { 42, -1e-9, 0.1, 1.5e300, 5e-324, 123456.789, 1e21, 0.000001, -0.0, 1.7976931348623157e308 };
+	const char *expect[] = { "42", "-1e-9", "0.1", "1.5e+300", "5e-324", "123456.789", "1e+21", "0.000001", "-0", "1.7976931348623157e+308" };
+	jsonez *json = jsonez_create_root();
+	char key[8];
+	for (int i = 0; i < 10; i++) {
+		sprintf(key, "n%d", i);
+		jsonez_create_numd(json, key, values[i]);
+	}
+	jsonez_create_numi(json, (char *)"int", -2147483647);
+
+	jsonez_ctx ctx = { false, 0, false, false };
+	char *str = jsonez_to_string(json, &ctx);
+	for (int i = 0; i < 10; i++) {
+		char want[64];
+		sprintf(want, "n%d: %s", i, expect[i]);
+		char *found = strstr(str, want);
+		mu_assert(found && strchr(",\n", found[strlen(want)]), "Should print the shortest digits");
+	}
+	mu_assert(strstr(str, "int: -2147483647"), "Should print the integer");
+
+	// and every one of them reads back as the same double
+	jsonez *back = jsonez_parse(str);
+	for (int i = 0; i < 10; i++) {
+		sprintf(key, "n%d", i);
+		jsonez *n = jsonez_find(back, key);
+		mu_assert(n && !memcmp(&n->n, &values[i], sizeof(double)), "Should read back exactly");
+	}
+	jsonez_free(back);
+	jsonez_free_string(str);
+	jsonez_free(json);
+
+	return NULL;
+
+}
+
+
+const char *test_int64() {
+
+	char text[] = "{ big: 9007199254740993, max: 9223372036854775807, min: -9223372036854775808,"
+		" umax: 18446744073709551615, over: 18446744073709551616, neg: -42, frac: 2.5, whole: 3e2 }";
+	jsonez *json = jsonez_parse(text);
+	mu_assert(json && json->i == 8, "Should have eight things");
+
+	int64_t i;
+	uint64_t u;
+	double d;
+	mu_assert(jsonez_get_int64(jsonez_find(json, "big"), &i) && i == 9007199254740993LL, "Should keep ids above 2^53");
+	mu_assert(jsonez_get_int64(jsonez_find(json, "max"), &i) && i == INT64_MAX, "Wrong int64 max");
+	mu_assert(jsonez_get_int64(jsonez_find(json, "min"), &i) && i == INT64_MIN, "Wrong int64 min");
+	mu_assert(!jsonez_get_int64(jsonez_find(json, "umax"), &i), "Should not fit an int64");
+	mu_assert(jsonez_get_uint64(jsonez_find(json, "umax"), &u) && u == UINT64_MAX, "Wrong uint64 max");
+	mu_assert(jsonez_find(json, "umax")->flags & JSONEZ_NODE_UINT, "Should be unsigned");
+	mu_assert(!(jsonez_find(json, "over")->flags & (JSONEZ_NODE_INT | JSONEZ_NODE_UINT)), "Should only be a double");
+	mu_assert(!jsonez_get_uint64(jsonez_find(json, "neg"), &u), "Negative should not fit a uint64");
+	mu_assert(jsonez_get_int64(jsonez_find(json, "neg"), &i) && i == -42, "Wrong negative");
+	mu_assert(jsonez_find(json, "neg")->n == -42, "Should still have the double");
+	mu_assert(!jsonez_get_int64(jsonez_find(json, "frac"), &i), "Fractions are not integers");
+	mu_assert(jsonez_get_double(jsonez_find(json, "frac"), &d) && d == 2.5, "Wrong double");
+	mu_assert(jsonez_get_int64(jsonez_find(json, "whole"), &i) && i == 300, "Whole doubles should convert");
+	mu_assert(!jsonez_get_int64(jsonez_find(json, "nope"), &i), "Missing should fail");
+	jsonez_free(json);
+
+	json = jsonez_create_root();
+	jsonez_create_int64(json, (char *)"id", 1234567890123456789LL);
+	jsonez_create_uint64(json, (char *)"mask", UINT64_MAX);
+	char *str = jsonez_to_string(json, NULL);
+	mu_assert(strstr(str, "1234567890123456789") && strstr(str, "18446744073709551615"), "Should print exact integers");
+	jsonez_free_string(str);
+	jsonez_free(json);
+
+	return NULL;
+
+}
+
+
+const char *test_parse_numbers() {
+
+	char text[] = "{ a: 42, b: -17, c: 0.1, d: 1e23, e: 2.2250738585072011e-308, f: 4.9406564584124654e-324,"
+		" g: 9007199254740993, h: 1.00000000000000011102230246251565404236316680908203125,"
+		" i: 123456789012345678901234567890, j: -0.0, k: 1.7976931348623157e308, l: 0.000001234E+3 }";
+	jsonez *json = jsonez_parse(text);
+	mu_assert(json && json->i == 12, "Should have twelve things");
+	mu_assert(jsonez_find(json, "a")->n == 42, "Wrong int");
+	mu_assert(jsonez_find(json, "b")->n == -17, "Wrong negative int");
+	mu_assert(jsonez_find(json, "c")->n == 0.1, "Wrong fraction");
+	mu_assert(jsonez_find(json, "d")->n == 1e23, "Wrong exponent");
+	mu_assert(jsonez_find(json, "e")->n == 2.2250738585072011e-308, "Wrong subnormal");
+	mu_assert(jsonez_find(json, "f")->n == 4.9406564584124654e-324, "Wrong smallest subnormal");
+	mu_assert(jsonez_find(json, "g")->n == 9007199254740992.0, "Halfway should round to even");
+	mu_assert(jsonez_find(json, "h")->n == 1.0, "Exactly halfway should round to even");
+	mu_assert(jsonez_find(json, "i")->n == 123456789012345678901234567890.0, "Wrong long mantissa");
+	mu_assert(jsonez_find(json, "j")->n == 0, "Wrong negative zero");
+	mu_assert(jsonez_find(json, "k")->n == 1.7976931348623157e308, "Wrong largest double");
+	mu_assert(jsonez_find(json, "l")->n == 0.001234, "Wrong small exponent");
+	jsonez_free(json);
+
+	// these are all errors, but a node still comes back
+	const char *bad[] = { "n: 1.2.3", "n: 1e", "n: 1e400", "n: -", "n: 1-2" };
+	for (int i = 0; i < (int)(sizeof(bad) / sizeof(bad[0])); i++) {
+		json = jsonez_parse_n(bad[i], strlen(bad[i]), NULL);
+		mu_assert(json && (!json->child || json->child->type != JSON_NUMBER), "Should not be a number");
+		jsonez_free(json);
+	}
+
+	return NULL;
+
+}
+
+
+const char *test_long_strings() {
+
+	// escapes land on every offset of a 16 and 32 byte lane
+	char text[16384];
+	char want[128];
+	char *d = text;
+	d += sprintf(d, "{");
+	for (int i = 0; i < 64; i++) {
+		d += sprintf(d, "\"key %*s\\t%d\": \"%*s\\\"quoted\\\"%*s\\\\%d\",", i, "", i, i, "", 63 - i, "", i);
+	}
+	d += sprintf(d, "plain: \"%*s\" }", 200, "");
+
+	for (int insitu = 0; insitu < 2; insitu++) {
+		char copy[sizeof(text)];
+		strcpy(copy, text);
+		jsonez_parse_opts opts = {0};
+		opts.flags = insitu ? JSONEZ_PARSE_INSITU : 0;
+		jsonez *json = jsonez_parse_ex(copy, &opts);
+		mu_assert(json && json->i == 65, "Should have sixty five things");
+
+		int i = 0;
+		for (jsonez *item = json->child; i < 64; item = item->next, i++) {
+			sprintf(want, "key %*s\t%d", i, "", i);
+			mu_assert(!strcmp(item->key, want), "Wrong key");
+			sprintf(want, "%*s\"quoted\"%*s\\%d", i, "", 63 - i, "", i);
+			mu_assert(!strcmp(item->s, want), "Wrong string");
+		}
+		mu_assert(strlen(jsonez_find(json, "plain")->s) == 200, "Wrong plain string");
+		jsonez_free(json);
+	}
+
+	return NULL;
+
+}
+
+
+const char *test_simd_whitespace() {
+
+	// runs of whitespace and comments that straddle 16 and 32 byte lanes
+	char text[8192];
+	char *d = text;
+	d += sprintf(d, "{");
+	for (int i = 0; i < 40; i++) {
+		d += sprintf(d, "\n%*s// comment %*s number %d\n%*s/* block * %*s */ k%d :%*s%d,",
+			i, "", i % 37, "", i, (i * 7) % 41, "", i % 23, "", i, i % 35, "", i);
+	}
+	d += sprintf(d, "%*s}", 45, "");
+
+	jsonez *json = jsonez_parse(text);
+	mu_assert(json && json->i == 40, "Should have forty things");
+	mu_assert(jsonez_find(json, "k0")->n == 0, "Wrong first number");
+	mu_assert(jsonez_find(json, "k39")->n == 39, "Wrong last number");
+	jsonez_free(json);
+
+	// high bytes are not whitespace, even though they are negative chars
+	json = jsonez_parse_n("k: [1,                                  \xC3\xA9 2]", 44, NULL);
+	mu_assert(json && jsonez_find(json, "k")->i == 1, "Should stop at the high bytes");
+	jsonez_free(json);
+
+	// an unterminated comment ends at the slice, not the terminator
+	json = jsonez_parse_n("{ a: 1 /* never closed                      */ }", 30, NULL);
+	mu_assert(json, "Should still get something back");
+	jsonez_free(json);
+
+	return NULL;
+
+}
+
+
+const char *test_parse_file() {
+
+	const char *path = "jsonez_parse_file_test.json";
+	FILE *file = fopen(path, "wb");
+	mu_assert(file, "Should be able to write the test file");
+	fputs("// catalog\n{ name: \"cat\\talog\", count: 3, items: [\"a\", \"b\"] }", file);
+	fclose(file);
+
+	jsonez *json = jsonez_parse_file(path, NULL);
+	mu_assert(json && json->i == 3, "Should have three things");
+	mu_assert(!strcmp(jsonez_find(json, "name")->s, "cat\talog"), "Wrong string");
+	jsonez_free(json);
+
+	jsonez_parse_opts opts = {0};
+	opts.flags = JSONEZ_PARSE_KEEP_MAP;
+	json = jsonez_parse_file(path, &opts);
+	mu_assert(json && json->i == 3, "Should have three things");
+	mu_assert(!strcmp(jsonez_find(json, "name")->s, "cat\talog"), "Wrong borrowed string");
+	mu_assert(!strcmp(jsonez_find(json, "items")->child->next->s, "b"), "Wrong array item");
+	jsonez_free(json);
+
+	remove(path);
+	mu_assert(jsonez_parse_file(path, NULL) == NULL, "Missing files should give null");
+	return NULL;
+
+}
+
+
+const char *test_parse_n() {
+
+	const char *packet = "{ id: 1234, name: \"slice\", list: [true, false] }trailing garbage";
+	size_t len = strchr(packet, '}') - packet + 1;
+
+	// exactly len bytes and no terminator, so reading past the end is caught
+	char *data = (char *)malloc(len);
+	memcpy(data, packet, len);
+	jsonez *json = jsonez_parse_n(data, len, NULL);
+	mu_assert(json && json->i == 3, "Should have three things");
+	mu_assert(jsonez_find(json, "id")->n == 1234, "Wrong number");
+	mu_assert(!strcmp(jsonez_find(json, "name")->s, "slice"), "Wrong string");
+	mu_assert(jsonez_find(json, "list")->i == 2, "Wrong array");
+	mu_assert(!memcmp(data, packet, len), "Input should not be touched");
+	jsonez_free(json);
+	free(data);
+
+	// cutting through a number stops at the cut
+	json = jsonez_parse_n("id: 1234", 6, NULL);
+	mu_assert(jsonez_find(json, "id")->n == 12, "Should stop at the end of the slice");
+	jsonez_free(json);
+
+	// cutting through a string is an error, not an overread
+	len = strchr(packet, 'l') - packet;
+	data = (char *)malloc(len);
+	memcpy(data, packet, len);
+	json = jsonez_parse_n(data, len, NULL);
+	mu_assert(json && json->type == JSON_OBJ, "Should still get an object back");
+	jsonez_free(json);
+	free(data);
+
+	return NULL;
+
+}
+
+
+const char *test_parse_insitu() {
+
+	const char *file = R"(
+		raw:"plain", "quoted": "esc\"aped\n",
+		"k\tey"= [ "a", "b" ], next:1
+	)";
+	char *buf = strdup(file);
+	char *end = buf + strlen(buf);
+
+	jsonez_parse_opts opts = {0};
+	opts.flags = JSONEZ_PARSE_INSITU;
+	jsonez *json = jsonez_parse_ex(buf, &opts);
+	mu_assert(json && json->i == 4, "Should have four things");
+
+	jsonez *child = json->child;
+	mu_assert(!strcmp(child->key, "raw") && !strcmp(child->s, "plain"), "Wrong raw pair");
+	mu_assert(child->key >= buf && child->key < end, "Key should point into the input");
+	mu_assert(child->s >= buf && child->s < end, "String should point into the input");
+
+	child = child->next;
+	mu_assert(!strcmp(child->key, "quoted"), "Wrong quoted key");
+	mu_assert(!strcmp(child->s, "esc\"aped\n"), "Should unescape in place");
+
+	child = child->next;
+	mu_assert(!strcmp(child->key, "k\tey"), "Should unescape keys in place");
+	mu_assert(!strcmp(child->child->next->s, "b"), "Wrong array item");
+	mu_assert(jsonez_find(json, "next")->n == 1, "Wrong last value");
+
+	jsonez_free(json);
+	free(buf);
+	return NULL;
+
+}
+
+
+const char *test_interned_keys() {
+
+	const char *file = R"(
+		records: [
+			{ id: 1, "name": "a" },
+			{ id: 2, "name": "b" },
+			{ id: 3, "name": "c", "tab\tkey": true },
+		]
+	)";
+
+	jsonez *json = jsonez_parse((char *)file);
+	jsonez *records = jsonez_find(json, "records");
+	mu_assert(records && records->i == 3, "Should have three records");
+
+	jsonez *first = records->child;
+	jsonez *second = first->next;
+	mu_assert(first->key == NULL, "Array items should not have keys");
+	mu_assert(jsonez_find(first, "id")->key == jsonez_find(second, "id")->key, "Keys should be shared");
+	mu_assert(jsonez_find(first, "name")->key == jsonez_find(second, "name")->key, "Quoted keys should be shared");
+	jsonez_free(json);
+
+	const char *escaped = R"( "tab\tkey": 1, "quote\"key": 2 )";
+	jsonez_keypool *pool = jsonez_keypool_create();
+	jsonez_parse_opts opts = {0};
+	opts.keys = pool;
+	jsonez *a = jsonez_parse_ex((char *)escaped, &opts);
+	jsonez *b = jsonez_parse_ex((char *)escaped, &opts);
+	mu_assert(jsonez_find(a, "tab\tkey"), "Should unescape keys");
+	mu_assert(jsonez_find(a, "quote\"key")->n == 2, "Should unescape quotes in keys");
+	mu_assert(a->child->key == b->child->key, "Documents should share the pool");
+	jsonez_free(a);
+	mu_assert(!strcmp(b->child->key, "tab\tkey"), "Keys should outlive the first document");
+	jsonez_free(b);
+	jsonez_keypool_destroy(pool);
+
+	// a detached node keeps its keys after its document is gone
+	json = jsonez_parse((char *)file);
+	records = jsonez_find(json, "records");
+	jsonez *moved = jsonez_detach(json, records);
+	jsonez *root = jsonez_create_root();
+	jsonez_insert_before(root, NULL, moved);
+	jsonez_free(json);
+	mu_assert(!strcmp(root->child->key, "records"), "Should keep its key");
+	mu_assert(!strcmp(jsonez_find(moved->child->prev, "tab\tkey")->key, "tab\tkey"), "Should keep the keys below it");
+	mu_assert(!strcmp(jsonez_find(moved->child, "name")->s, "a"), "Should keep its strings");
+	jsonez_free(root);
+
+	return NULL;
+
+}
+
+
+const char *test_find_index() {
+
+	char key[32];
+	jsonez *root = jsonez_create_root();
+	for (int i = 0; i < 1000; ++i) {
+		snprintf(key, sizeof(key), "flag_%d", i);
+		jsonez_create_numi(root, key, i);
+	}
+	jsonez_create_numi(root, (char *)"flag_7", -7);
+
+	for (int i = 0; i < 1000; ++i) {
+		snprintf(key, sizeof(key), "flag_%d", i);
+		jsonez *found = jsonez_find(root, key);
+		mu_assert(found && found->n == i, "Should find every key");
+	}
+	mu_assert(root->index, "Wide object should be indexed");
+	mu_assert(!jsonez_find(root, "flag_1000"), "Should not find a missing key");
+
+	// removing the first flag_7 uncovers the duplicate
+	jsonez_delete(root, jsonez_find(root, "flag_7"));
+	mu_assert(jsonez_find(root, "flag_7")->n == -7, "Should find the duplicate");
+	jsonez_delete(root, jsonez_find(root, "flag_500"));
+	mu_assert(!jsonez_find(root, "flag_500"), "Should be gone");
+	mu_assert(jsonez_find(root, "flag_501")->n == 501, "Neighbours should survive");
+
+	jsonez *item = jsonez_create_numi(NULL, (char *)"flag_500", 5000);
+	jsonez_insert_before(root, root->child, item);
+	mu_assert(jsonez_find(root, "flag_500") == item, "Should find the inserted key");
+	jsonez_free(root);
+
+	const char *file = R"(
+		a0:0, a1:1, a2:2, a3:3, a4:4, a5:5, a6:6, a7:7, a8:8, a9:9,
+		b0:0, b1:1, b2:2, b3:3, b4:4, b5:5, b6:6, b7:7, b8:8, b9:9,
+		nested: { c0:0, c1:1, c2:2, c3:3, c4:4, c5:5, c6:6, c7:7, c8:8, c9:9,
+			d0:0, d1:1, d2:2, d3:3, d4:4, d5:5, d6:6, d7:7, d8:8, d9:9 },
+	)";
+	jsonez_parse_opts opts = {0};
+	opts.flags = JSONEZ_PARSE_INDEX;
+	jsonez *json = jsonez_parse_ex((char *)file, &opts);
+	mu_assert(json->index, "Root should be indexed while parsing");
+	jsonez *nested = jsonez_find(json, "nested");
+	mu_assert(nested && nested->index, "Nested object should be indexed while parsing");
+	mu_assert(jsonez_find(nested, "d7")->n == 7, "Should find nested keys");
+	jsonez_free(json);
+
+	return NULL;
+
+}
+
+
+const char *test_insert_remove() {
+
+	jsonez *root = jsonez_create_root();
+	jsonez *arr = jsonez_create_array(root, (char *)"array");
+	for (int i = 0; i < 100000; ++i) {
+		jsonez_create_numi(arr, NULL, i);
+	}
+	mu_assert(arr->i == 100000, "Should have all the items");
+	mu_assert(arr->child->prev->n == 99999, "First child should point at the last");
+
+	jsonez *first = arr->child;
+	jsonez *last = arr->child->prev;
+	jsonez_delete(arr, first);
+	mu_assert(arr->child->n == 1, "First item should be gone");
+	mu_assert(jsonez_detach(arr, last) == last, "Should get the last item back");
+	mu_assert(arr->child->prev->n == 99998, "Last item should be gone");
+	mu_assert(arr->i == 99998, "Count should follow removals");
+
+	jsonez_insert_before(arr, arr->child, last);
+	mu_assert(arr->child == last, "Should be at the front");
+	jsonez *item = jsonez_create_numi(NULL, NULL, -1);
+	jsonez_insert_before(arr, arr->child->next, item);
+	mu_assert(last->next == item && item->prev == last, "Should be second");
+	mu_assert(item->next->n == 1, "Should be in front of the old first");
+	mu_assert(arr->i == 100000, "Count should follow inserts");
+
+	jsonez_free(root);
+	return NULL;
+
+}
+
+
+const char *test_arena() {
+
+	const char *file = R"(
+		name: "arena",
+		list: [1, 2, { deep: "value" }],
+		flag: true,
+	)";
+
+	jsonez_arena *arena = jsonez_arena_create(64);
+	mu_assert(arena, "Should get an arena");
+
+	for (int pass = 0; pass < 3; ++pass) {
+		jsonez *json = jsonez_parse_arena(arena, (char *)file);
+		mu_assert(json, "Should get something back");
+		mu_assert(json->type == JSON_OBJ, "Should be an object");
+		mu_assert(json->i == 3, "Should have three things");
+
+		jsonez *child = jsonez_find(json, "name");
+		mu_assert(child && child->type == JSON_STRING, "Wrong type");
+		mu_assert(!strcmp(child->s, "arena"), "Wrong value");
+
+		child = jsonez_find(json, "list");
+		mu_assert(child && child->type == JSON_ARRAY, "Wrong type");
+		mu_assert(child->i == 3, "Should have three items");
+		child = jsonez_find(child->child->next->next, "deep");
+		mu_assert(child && !strcmp(child->s, "value"), "Wrong nested value");
+
+		mu_assert(jsonez_arena_used(arena) > 0, "Should have used the arena");
+		jsonez_arena_reset(arena);
+		mu_assert(jsonez_arena_used(arena) == 0, "Reset should empty the arena");
+	}
+
+	jsonez_arena_destroy(arena);
+	return NULL;
+
+}
+
+
 const char *test_parse_011() {
 
 	const char* file = R"(
@@ -841,6 +2211,31 @@ const char* all_tests() {
 	mu_run_test(test_parse_009);
 	mu_run_test(test_parse_010);
 	mu_run_test(test_parse_011);
+	mu_run_test(test_arena);
+	mu_run_test(test_insert_remove);
+	mu_run_test(test_find_index);
+	mu_run_test(test_interned_keys);
+	mu_run_test(test_parse_insitu);
+	mu_run_test(test_parse_n);
+	mu_run_test(test_parse_file);
+	mu_run_test(test_simd_whitespace);
+	mu_run_test(test_long_strings);
+	mu_run_test(test_parse_numbers);
+	mu_run_test(test_int64);
+	mu_run_test(test_print_numbers);
+	mu_run_test(test_to_buffer);
+	mu_run_test(test_write_sink);
+	mu_run_test(test_deep_and_long);
+	mu_run_test(test_stream_chunks);
+	mu_run_test(test_sax);
+	mu_run_test(test_cursor);
+	mu_run_test(test_tape);
+	mu_run_test(test_array_at);
+	mu_run_test(test_ndjson);
+	mu_run_test(test_parallel_array);
+	mu_run_test(test_two_stage);
+	mu_run_test(test_parse_errors);
+	mu_run_test(test_validate);
 
 	return NULL;
 }